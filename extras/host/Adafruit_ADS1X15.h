@@ -0,0 +1,58 @@
+/**
+ * @file Adafruit_ADS1X15.h
+ * @brief Substituto do driver ADS1115 para o build no host.
+ *
+ * As conversões retornam hostAdsValue[canal] e terminam imediatamente. Com
+ * hostAdsResponding = false o chip para de responder: nenhuma conversão termina.
+ */
+
+#ifndef HOST_ADAFRUIT_ADS1X15_H
+#define HOST_ADAFRUIT_ADS1X15_H
+
+#include <Wire.h>
+
+typedef enum {
+    GAIN_TWOTHIRDS = 0x0000,
+    GAIN_ONE = 0x0200,
+    GAIN_TWO = 0x0400,
+    GAIN_FOUR = 0x0600,
+    GAIN_EIGHT = 0x0800,
+    GAIN_SIXTEEN = 0x0A00
+} adsGain_t;
+
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_0 (0x4000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_1 (0x5000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_2 (0x6000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_3 (0x7000)
+#define RATE_ADS1115_8SPS (0x0000)
+#define RATE_ADS1115_16SPS (0x0020)
+#define RATE_ADS1115_32SPS (0x0040)
+#define RATE_ADS1115_64SPS (0x0060)
+#define RATE_ADS1115_128SPS (0x0080)
+#define RATE_ADS1115_250SPS (0x00A0)
+#define RATE_ADS1115_475SPS (0x00C0)
+#define RATE_ADS1115_860SPS (0x00E0)
+
+int16_t hostAdsValue[4]; ///< Valor convertido de cada canal.
+bool hostAdsPresent = true; ///< false simula o ADS1115 ausente no I2C (begin() falha).
+bool hostAdsResponding = true; ///< false simula o chip parando de responder depois do begin().
+
+class Adafruit_ADS1X15 {
+public:
+    bool begin(uint8_t = 0x48, TwoWire * = &Wire) { return hostAdsPresent; }
+    void setGain(adsGain_t gain) { _gain = gain; }
+    adsGain_t getGain() { return _gain; }
+    void setDataRate(uint16_t) {}
+    int16_t readADC_SingleEnded(uint8_t channel) { return hostAdsValue[channel & 3]; }
+    void startADCReading(uint16_t mux, bool) { _channel = ((mux >> 12) & 3); }
+    bool conversionComplete() { return hostAdsResponding; }
+    int16_t getLastConversionResults() { return hostAdsValue[_channel]; }
+
+protected:
+    adsGain_t _gain = GAIN_TWOTHIRDS;
+    uint8_t _channel = 0;
+};
+
+class Adafruit_ADS1115 : public Adafruit_ADS1X15 {};
+
+#endif
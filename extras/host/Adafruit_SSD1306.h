@@ -0,0 +1,33 @@
+/**
+ * @file Adafruit_SSD1306.h
+ * @brief Substituto do driver SSD1306 para o build no host: desenha em lugar nenhum,
+ * mas conta os bytes que seriam enviados, para medir o custo de Display_c::update().
+ */
+
+#ifndef HOST_ADAFRUIT_SSD1306_H
+#define HOST_ADAFRUIT_SSD1306_H
+
+#include <Wire.h>
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_WHITE 1
+
+class Adafruit_SSD1306 : public Print {
+public:
+    uint32_t frames = 0;     ///< Chamadas de display().
+    uint32_t chars = 0;      ///< Caracteres desenhados.
+
+    Adafruit_SSD1306(int16_t, int16_t, TwoWire *, int8_t) {}
+    bool begin(uint8_t, uint8_t) { return true; }
+    size_t write(uint8_t) override { chars++; return 1; }
+    using Print::write;
+    void clearDisplay() {}
+    void display() { frames++; }
+    void setTextWrap(bool) {}
+    void setTextColor(uint16_t) {}
+    void setTextSize(uint8_t) {}
+    void setCursor(int16_t, int16_t) {}
+    void cp437(bool) {}
+};
+
+#endif
@@ -0,0 +1,271 @@
+/**
+ * @file Arduino.h
+ * @brief Substituto mínimo do Arduino core para compilar a biblioteca no Linux (host).
+ *
+ * Fornece String, Print/Stream, Serial/Serial2 com buffers de entrada e saída
+ * inspecionáveis, GPIO simulado e millis()/micros() derivados de um relógio virtual
+ * controlado pelo programa (hostClockAdvance()). delay() apenas avança o relógio.
+ *
+ * Uso: g++ -std=gnu++11 -Iextras/host -Iinclude programa.cpp (ou os alvos do CMakeLists.txt
+ * da raiz: testes em extras/host/tests e benchmarks em extras/host/bench).
+ *
+ * Assim como a própria biblioteca, estes cabeçalhos definem objetos globais e devem ser
+ * incluídos em uma única unidade de compilação.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+#define ANALOG 0xC0
+#define LOW 0x0
+#define HIGH 0x1
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8O1 0x800003f
+#define IRAM_ATTR
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+/********** Relógio virtual ***********/
+uint64_t _hostMicros = 0; ///< Tempo virtual em microssegundos.
+
+/**
+ * @brief Avança o relógio virtual.
+ */
+inline void hostClockAdvance(uint64_t us) { _hostMicros += us; }
+
+/**
+ * @brief Define o relógio virtual.
+ */
+inline void hostClockSet(uint64_t us) { _hostMicros = us; }
+
+inline unsigned long micros() { return (unsigned long)(uint32_t)_hostMicros; }
+inline unsigned long millis() { return (unsigned long)(uint32_t)(_hostMicros / 1000ULL); }
+inline void delay(uint32_t ms) { _hostMicros += (uint64_t)ms * 1000ULL; }
+inline void delayMicroseconds(uint32_t us) { _hostMicros += us; }
+inline void yield() {}
+uint32_t _hostCpuMhz = 240; ///< Clock da CPU simulado.
+inline uint32_t getCpuFrequencyMhz() { return _hostCpuMhz; }
+inline bool setCpuFrequencyMhz(uint32_t mhz) {
+    _hostCpuMhz = mhz;
+    return true;
+}
+
+/********** String ***********/
+class String : public std::string {
+public:
+    String() {}
+    String(const char *s) : std::string(s != NULL ? s : "") {}
+    String(const std::string &s) : std::string(s) {}
+    String(char c) : std::string(1, c) {}
+    String(int v) : std::string(std::to_string(v)) {}
+    String(unsigned v) : std::string(std::to_string(v)) {}
+    String(long v) : std::string(std::to_string(v)) {}
+    String(unsigned long v) : std::string(std::to_string(v)) {}
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return (float)atof(c_str()); }
+    void trim() {
+        const size_t b = find_first_not_of(" \t\r\n");
+        const size_t e = find_last_not_of(" \t\r\n");
+        *this = (b == npos) ? String() : String(std::string::substr(b, e - b + 1));
+    }
+    int indexOf(char c, unsigned from = 0) const {
+        const size_t p = find(c, from);
+        return p == npos ? -1 : (int)p;
+    }
+    String substring(unsigned from) const { return String(std::string::substr(from)); }
+    String substring(unsigned from, unsigned to) const { return String(std::string::substr(from, to - from)); }
+    bool startsWith(const char *prefix) const { return rfind(prefix, 0) == 0; }
+};
+
+/********** Print / Stream ***********/
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        for (size_t i = 0; i < size; i++) write(buffer[i]);
+        return size;
+    }
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(short v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned short v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC) {
+        if (base == DEC && v < 0) return print('-') + print((unsigned long)(-v), base);
+        return print((unsigned long)v, base);
+    }
+    size_t print(unsigned long v, int base = DEC) { return print((unsigned long long)v, base); }
+    size_t print(long long v, int base = DEC) {
+        if (base == DEC && v < 0) return print('-') + print((unsigned long long)(-v), base);
+        return print((unsigned long long)v, base);
+    }
+    size_t print(unsigned long long v, int base = DEC) {
+        char buf[65];
+        char *p = &buf[sizeof(buf) - 1];
+        *p = '\0';
+        if (base < 2) base = 10;
+        do {
+            const unsigned d = v % base;
+            *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+            v /= base;
+        } while (v != 0);
+        return print(p);
+    }
+    size_t print(double v, int digits = 2) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", digits, v);
+        return print(buf);
+    }
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(const T &v) { return print(v) + println(); }
+    template <typename T>
+    size_t println(const T &v, int base) { return print(v, base) + println(); }
+    int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+#include <stdarg.h>
+inline int Print::printf(const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    print(buf);
+    return n;
+}
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    String readStringUntil(char terminator) {
+        String s;
+        int c;
+        while ((c = read()) >= 0 && c != terminator) s += (char)c;
+        return s;
+    }
+};
+
+/**
+ * @class HardwareSerial
+ * @brief UART simulada: o que é escrito vai para tx e o que é lido vem de rx.
+ */
+class HardwareSerial : public Stream {
+public:
+    std::string tx;       ///< Bytes enviados pela aplicação.
+    std::string rx;       ///< Bytes a serem recebidos pela aplicação.
+    size_t rxPos = 0;     ///< Próximo byte de rx a ser lido.
+    bool capture = true;  ///< false descarta a saída (útil em benchmarks).
+
+    void begin(unsigned long, uint32_t = SERIAL_8N1, int8_t = -1, int8_t = -1) {}
+    void end() {}
+    void flush() {}
+    void (*rxCallback)(void) = NULL; ///< Callback de onReceive(), chamado por inject().
+    void onReceive(void (*callback)(void), bool = false) { rxCallback = callback; }
+    operator bool() const { return true; }
+    size_t write(uint8_t c) override {
+        if (capture) tx.push_back((char)c);
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override {
+        if (capture) tx.append((const char *)buffer, size);
+        return size;
+    }
+    using Print::write;
+    int available() override { return (int)(rx.size() - rxPos); }
+    int read() override { return rxPos < rx.size() ? (uint8_t)rx[rxPos++] : -1; }
+    /**
+     * @brief Injeta bytes na entrada da UART.
+     */
+    void inject(const char *s) {
+        rx.append(s);
+        if (rxCallback != NULL) rxCallback();
+    }
+};
+
+HardwareSerial Serial;
+HardwareSerial Serial2;
+
+/********** GPIO simulado ***********/
+uint8_t _hostPinLevel[40];     ///< Nível digital de cada pino.
+uint16_t _hostPinAnalog[40];   ///< Valor retornado por analogRead() em cada pino.
+uint8_t _hostPinMode[40];      ///< Último modo passado a pinMode().
+
+/**
+ * @brief Sinal de periférico ligado à saída de cada pino pelo GPIO matrix (256 = nenhum,
+ * SIG_GPIO_OUT_IDX). Lido por GPIO.func_out_sel_cfg[pin].func_sel.
+ */
+struct HostPinSignals {
+    uint16_t sig[40];
+    HostPinSignals() {
+        for (uint8_t i = 0; i < 40; i++) sig[i] = 256;
+    }
+} _hostPinSignal;
+
+inline void pinMode(uint8_t pin, uint8_t mode) { if (pin < 40) _hostPinMode[pin] = mode; }
+inline void pinMatrixOutAttach(uint8_t pin, uint8_t function, bool, bool) { if (pin < 40) _hostPinSignal.sig[pin] = function; }
+inline void pinMatrixOutDetach(uint8_t pin, bool, bool) { if (pin < 40) _hostPinSignal.sig[pin] = 256; }
+inline void digitalWrite(uint8_t pin, uint8_t val) { if (pin < 40) _hostPinLevel[pin] = val; }
+inline int digitalRead(uint8_t pin) { return pin < 40 ? _hostPinLevel[pin] : 0; }
+inline void analogWrite(uint8_t, int) {}
+inline uint16_t analogRead(uint8_t pin) { return pin < 40 ? _hostPinAnalog[pin] : 0; }
+void (*_hostPinIsr[40])(void *);  ///< ISR registrada em cada pino.
+void *_hostPinIsrArg[40];         ///< Argumento da ISR.
+int _hostPinIsrMode[40];          ///< RISING, FALLING ou CHANGE.
+
+inline void attachInterrupt(uint8_t, void (*)(void), int) {}
+inline void attachInterruptArg(uint8_t pin, void (*isr)(void *), void *arg, int mode) {
+    if (pin >= 40) return;
+    _hostPinIsr[pin] = isr;
+    _hostPinIsrArg[pin] = arg;
+    _hostPinIsrMode[pin] = mode;
+}
+inline void detachInterrupt(uint8_t pin) { if (pin < 40) _hostPinIsr[pin] = NULL; }
+
+/**
+ * @brief Altera o nível de uma entrada simulada e executa a ISR registrada, se a borda coincidir.
+ */
+inline void hostPinSet(uint8_t pin, uint8_t level) {
+    if (pin >= 40) return;
+    const uint8_t old = _hostPinLevel[pin];
+    _hostPinLevel[pin] = level;
+    if (_hostPinIsr[pin] == NULL || old == level) return;
+    const int edge = level ? RISING : FALLING;
+    if (_hostPinIsrMode[pin] == CHANGE || _hostPinIsrMode[pin] == edge) _hostPinIsr[pin](_hostPinIsrArg[pin]);
+}
+inline long random(long howbig) { return howbig > 0 ? rand() % howbig : 0; }
+
+#endif
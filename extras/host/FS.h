@@ -0,0 +1,123 @@
+/**
+ * @file FS.h
+ * @brief Substituto do sistema de arquivos do core para o build no host: arquivos em RAM.
+ *
+ * Os arquivos ficam em hostFsFiles, indexados pelo caminho completo ("/log/00000001.bin").
+ * Os diretórios não são guardados: um diretório lista os arquivos cujo caminho começa por
+ * ele. File::name() retorna só o nome, sem o diretório, como no core 2.x.
+ */
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+std::map<std::string, std::vector<uint8_t> > hostFsFiles; ///< Conteúdo do sistema de arquivos simulado.
+size_t hostFsTotal = 1024 * 1024;  ///< Capacidade (bytes) informada por totalBytes().
+bool hostFsRemoveFails = false;    ///< true faz remove() falhar, como em uma flash com defeito.
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+public:
+    File() {}
+    File(const std::string &path, bool write) : _path(new std::string(path)), _write(write) {}
+    File(const std::string &path, const std::vector<std::string> &entries)
+        : _path(new std::string(path)), _entries(new std::vector<std::string>(entries)), _dir(true) {}
+
+    operator bool() const { return _path && (_dir || hostFsFiles.count(*_path) != 0); }
+    const char *path() const { return _path ? _path->c_str() : ""; }
+    const char *name() const {
+        const char *p = path();
+        const char *slash = strrchr(p, '/');
+        return slash != NULL ? slash + 1 : p;
+    }
+    bool isDirectory() const { return _dir; }
+    size_t size() const { return *this && !_dir ? data().size() : 0; }
+    size_t position() const { return _pos; }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+        if (!*this || _dir) return false;
+        const size_t base = (mode == SeekSet) ? 0 : (mode == SeekCur ? _pos : data().size());
+        if (base + pos > data().size()) return false;
+        _pos = base + pos;
+        return true;
+    }
+    size_t read(uint8_t *buf, size_t n) {
+        if (!*this || _dir || _pos >= data().size()) return 0;
+        if (n > data().size() - _pos) n = data().size() - _pos;
+        memcpy(buf, data().data() + _pos, n);
+        _pos += n;
+        return n;
+    }
+    size_t write(const uint8_t *buf, size_t n) {
+        if (!*this || !_write) return 0;
+        std::vector<uint8_t> &d = hostFsFiles[*_path];
+        if (_pos + n > d.size()) d.resize(_pos + n);
+        memcpy(d.data() + _pos, buf, n);
+        _pos += n;
+        return n;
+    }
+    void flush() {}
+    void close() { _path.reset(); }
+    File openNextFile(const char * = "r") {
+        if (!_dir || _next >= _entries->size()) return File();
+        return File((*_entries)[_next++], false);
+    }
+
+private:
+    const std::vector<uint8_t> &data() const { return hostFsFiles[*_path]; }
+
+    std::shared_ptr<std::string> _path;
+    std::shared_ptr<std::vector<std::string> > _entries; ///< Conteúdo do diretório ao abri-lo.
+    size_t _next = 0;
+    size_t _pos = 0;
+    bool _write = false;
+    bool _dir = false;
+};
+
+class FS {
+public:
+    File open(const char *path, const char *mode = "r", bool = false) {
+        const std::string p(path);
+        if (mode[0] == 'w') {
+            hostFsFiles[p].clear();
+            return File(p, true);
+        }
+        if (hostFsFiles.count(p) != 0) return File(p, mode[0] == 'a' || strchr(mode, '+') != NULL);
+        // Diretório: os arquivos imediatamente abaixo de path, na ordem do mapa.
+        const std::string prefix = p + "/";
+        std::vector<std::string> entries;
+        for (std::map<std::string, std::vector<uint8_t> >::const_iterator it = hostFsFiles.begin(); it != hostFsFiles.end(); ++it) {
+            if (it->first.compare(0, prefix.size(), prefix) == 0 && it->first.find('/', prefix.size()) == std::string::npos) {
+                entries.push_back(it->first);
+            }
+        }
+        return File(p, entries);
+    }
+    bool exists(const char *path) { return hostFsFiles.count(path) != 0; }
+    bool remove(const char *path) { return !hostFsRemoveFails && hostFsFiles.erase(path) != 0; }
+    bool mkdir(const char *) { return true; }
+    size_t totalBytes() { return hostFsTotal; }
+    size_t usedBytes() {
+        size_t used = 0;
+        for (std::map<std::string, std::vector<uint8_t> >::const_iterator it = hostFsFiles.begin(); it != hostFsFiles.end(); ++it) {
+            used += it->second.size();
+        }
+        return used;
+    }
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * @file LittleFS.h
+ * @brief Substituto do LittleFS para o build no host (ver FS.h).
+ */
+
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <FS.h>
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool = false, const char * = "/littlefs", uint8_t = 10, const char * = "spiffs") { return true; }
+    void end() {}
+};
+
+} // namespace fs
+
+fs::LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,38 @@
+/**
+ * @file Preferences.h
+ * @brief Substituto da NVS para o build no host: um único namespace mantido em RAM.
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+std::map<std::string, std::vector<uint8_t> > hostNvs; ///< Conteúdo da NVS simulada.
+
+class Preferences {
+public:
+    bool begin(const char *, bool readOnly = false, const char * = NULL) {
+        _readOnly = readOnly;
+        return true;
+    }
+    void end() {}
+    size_t getBytes(const char *key, void *buf, size_t maxLen) {
+        std::map<std::string, std::vector<uint8_t> >::const_iterator it = hostNvs.find(key);
+        if (it == hostNvs.end() || it->second.size() > maxLen) return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+    size_t putBytes(const char *key, const void *value, size_t len) {
+        if (_readOnly) return 0;
+        hostNvs[key].assign((const uint8_t *)value, (const uint8_t *)value + len);
+        return len;
+    }
+
+private:
+    bool _readOnly = false;
+};
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file Wire.h
+ * @brief Substituto do barramento I2C para o build no host (não acessa hardware).
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    bool setPins(int, int) { return true; }
+    bool begin() { return true; }
+    void setClock(uint32_t) {}
+};
+
+TwoWire Wire;
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file bench_hotpaths.cpp
+ * @brief Custo por operação dos caminhos executados a cada amostra, bloco ou ciclo do loop.
+ *
+ * Serial.capture = false: a saída da serial é descartada, então plot() mede só a
+ * formatação e não o crescimento de Serial.tx. Os blocos têm JPOOL_BLOCK_LEN amostras.
+ */
+
+#include "iikitmini.h"
+#include "util/AdcDmaEsp.h"
+#include "util/jtask.h"
+#include "util/jqueue.h"
+#include "util/jpool.h"
+#include "util/jcontrol.h"
+#include "util/jalarm.h"
+#include "util/jstats.h"
+#include "util/hartSerial.h"
+#include "hostBench.h"
+
+int16_t block[JPOOL_BLOCK_LEN];
+uint32_t adcSamples = 0;
+uint32_t taskRuns = 0;
+
+void adcCallback(const int16_t *, size_t count) { adcSamples += count; }
+void task() { taskRuns++; }
+int32_t controlInput() { return block[0]; }
+void controlOutput(int32_t q16) { hostBenchSink = (uint32_t)q16; }
+void statsSink(uint8_t, const JStatsSummary_t &s) { hostBenchSink = s.count; }
+
+int main() {
+    IIKit.setup();
+    hostTaskRun("iikitBoot");
+    Serial.capture = false;
+    for (int i = 0; i < JPOOL_BLOCK_LEN; i++) block[i] = (int16_t)(2048 + 1000 * sin(i * 0.1));
+
+    uint64_t t0 = 0;
+    hostBench("WSerial.plot block", 20000, [&]() {
+        IIKit.WSerial.plot("adc", t0, 1000, block, JPOOL_BLOCK_LEN);
+        t0 += JPOOL_BLOCK_LEN * 1000ULL;
+    });
+    hostBench("WSerial.plot value", 200000, []() { IIKit.WSerial.plot("pot1", (uint32_t)1234, 0.5f); });
+
+    for (int i = 0; i < 8; i++) jtaskAttachFunc(task, 1000UL * (i + 1));
+    hostBench("jtaskLoop 8 tasks", 200000, []() {
+        hostClockAdvance(100);
+        jtaskLoop();
+    });
+
+    jQueue_t queue;
+    jQueueInit(&queue);
+    hostBench("jQueue send+receive", 1000000, [&]() {
+        void *item;
+        jQueueSendFromISR(&queue, block);
+        jQueueReceive(&queue, &item);
+        hostBenchSink = (uint32_t)(uintptr_t)item;
+    });
+    hostBench("jpool alloc+release", 1000000, []() { jpoolRelease(jpoolAlloc()); });
+
+    uint32_t frame = 0;
+    hostBench("Display update (changed)", 200000, [&]() {
+        IIKit.disp.setText(2, (frame++ & 1) ? "PV: 12.5" : "PV: 12.6");
+        updateDisplay(&IIKit.disp);
+    });
+    hostBench("Display update (idle)", 1000000, []() { updateDisplay(&IIKit.disp); });
+
+    // Caminho do callback do ADC: leitura do DMA simulado e entrega de 100 amostras.
+    adcDmaSetup(ADC1_CHANNEL_0, 100, adcCallback, 10000);
+    hostBench("adcDmaLoop callback 100", 50000, []() {
+        hostClockAdvance(10000);
+        adcDmaLoop();
+    });
+
+    const int8_t loop = jcontrolAttach(controlInput, controlOutput, 1000);
+    jcontrolTune(loop, 0.001f, 1.0f, 0.0001f, 0.01f);
+    jcontrolSetpoint(loop, 2048);
+    jcontrolAuto(loop);
+    hostBench("jcontrolStep PID", 1000000, [&]() { jcontrolStep(jcontrolStruct[loop]); });
+
+    for (int i = 0; i < 4; i++) jalarmAdd(0, (uint8_t)i, 3000 - i * 700, 50, 10, 10);
+    uint64_t ta = 0;
+    hostBench("jalarmEvaluate 4 alarms", 100000, [&]() {
+        jalarmEvaluate(0, block, JPOOL_BLOCK_LEN, ta, 100);
+        ta += JPOOL_BLOCK_LEN * 100ULL;
+    });
+
+    jstatsAdd(0, 1000, statsSink);
+    uint64_t ts = 0;
+    hostBench("jstatsUpdate block", 100000, [&]() {
+        jstatsUpdate(0, block, JPOOL_BLOCK_LEN, ts, 100);
+        ts += JPOOL_BLOCK_LEN * 100ULL;
+    });
+
+    uint8_t request[32];
+    const uint8_t addr = 0x80;
+    const size_t requestLen = hartBuildRequest(request, &addr, 1, 1);
+    HartFrameParser parser;
+    hostBench("HartFrameParser frame", 1000000, [&]() {
+        for (size_t i = 0; i < requestLen; i++) hostBenchSink += parser.parse(request[i]);
+    });
+
+    printf("adc=%u tasks=%u\n", adcSamples, taskRuns);
+    return 0;
+}
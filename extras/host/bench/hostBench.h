@@ -0,0 +1,68 @@
+/**
+ * @file hostBench.h
+ * @brief Medição de tempo (ns/op) e de memória alocada no heap (B/op) no host.
+ *
+ * Substitui o operator new global para contar alocações: a String do Arduino e os
+ * contêineres da biblioteca padrão passam por ele. O tempo é o do relógio real
+ * (std::chrono::steady_clock), não o relógio virtual do shim.
+ *
+ * Uso:
+ * @code
+ * #include "iikitmini.h"
+ * #include "hostBench.h"
+ * int main() {
+ *     Serial.capture = false; // A saída não cresce em Serial.tx durante a medição.
+ *     hostBench("plot", 10000, []() { IIKit.WSerial.plot("v", 1.0f); });
+ * }
+ * @endcode
+ *
+ * Cada linha: "nome  ns/op  B/op  allocs/op". Deve ser incluído em uma única unidade de
+ * compilação, como os cabeçalhos do shim.
+ */
+
+#ifndef HOST_BENCH_H
+#define HOST_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+
+uint64_t _hostBenchAllocs = 0; ///< Alocações feitas pelo operator new.
+uint64_t _hostBenchBytes = 0;  ///< Bytes pedidos ao operator new.
+
+__attribute__((noinline)) void *operator new(size_t size) {
+    _hostBenchAllocs++;
+    _hostBenchBytes += size;
+    void *p = malloc(size != 0 ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { free(p); }
+
+/**
+ * @brief Impede que o compilador descarte um resultado calculado só para a medição.
+ */
+volatile uint32_t hostBenchSink = 0;
+
+/**
+ * @brief Executa fn iterations vezes (após um aquecimento de 1/10) e imprime o custo por operação.
+ * @param name Nome da medição.
+ * @param iterations Número de operações medidas.
+ * @param fn Operação (lambda sem argumentos).
+ */
+template <typename F>
+void hostBench(const char *name, uint32_t iterations, F fn) {
+    for (uint32_t i = 0; i < iterations / 10; i++) fn();
+    const uint64_t allocs0 = _hostBenchAllocs;
+    const uint64_t bytes0 = _hostBenchBytes;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) fn();
+    const auto end = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    printf("%-28s %12.1f ns/op %10.1f B/op %8.2f allocs/op\n", name, ns / iterations,
+           (double)(_hostBenchBytes - bytes0) / iterations, (double)(_hostBenchAllocs - allocs0) / iterations);
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file i2s.h
+ * @brief Substituto do driver I2S/ADC para o build no host.
+ *
+ * As leituras do ADC (i2s_read() e adc1_get_raw()) vêm de hostAdcSample, que pode ser
+ * trocada pelo programa para injetar sinais conhecidos. i2s_write() apenas contabiliza bytes.
+ */
+
+#ifndef HOST_DRIVER_I2S_H
+#define HOST_DRIVER_I2S_H
+
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1 } i2s_port_t;
+typedef enum {
+    I2S_MODE_MASTER = 1,
+    I2S_MODE_SLAVE = 2,
+    I2S_MODE_TX = 4,
+    I2S_MODE_RX = 8,
+    I2S_MODE_DAC_BUILT_IN = 16,
+    I2S_MODE_ADC_BUILT_IN = 32
+} i2s_mode_t;
+typedef enum { I2S_BITS_PER_SAMPLE_16BIT = 16 } i2s_bits_per_sample_t;
+typedef enum { I2S_CHANNEL_FMT_RIGHT_LEFT = 0, I2S_CHANNEL_FMT_ONLY_RIGHT = 3, I2S_CHANNEL_FMT_ONLY_LEFT = 4 } i2s_channel_fmt_t;
+typedef enum { I2S_COMM_FORMAT_STAND_I2S = 1, I2S_COMM_FORMAT_STAND_MSB = 3 } i2s_comm_format_t;
+typedef enum { I2S_MCLK_MULTIPLE_256 = 256 } i2s_mclk_multiple_t;
+typedef enum { I2S_DAC_CHANNEL_DISABLE = 0, I2S_DAC_CHANNEL_RIGHT_EN = 1, I2S_DAC_CHANNEL_LEFT_EN = 2, I2S_DAC_CHANNEL_BOTH_EN = 3 } i2s_dac_mode_t;
+typedef enum { ADC_UNIT_1 = 1 } adc_unit_t;
+typedef enum {
+    ADC1_CHANNEL_0 = 0, ADC1_CHANNEL_1, ADC1_CHANNEL_2, ADC1_CHANNEL_3,
+    ADC1_CHANNEL_4, ADC1_CHANNEL_5, ADC1_CHANNEL_6, ADC1_CHANNEL_7
+} adc1_channel_t;
+typedef enum { ADC_WIDTH_BIT_9 = 0, ADC_WIDTH_BIT_10, ADC_WIDTH_BIT_11, ADC_WIDTH_BIT_12 } adc_bits_width_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_12 } adc_atten_t;
+
+#define ESP_INTR_FLAG_LEVEL1 (1 << 1)
+
+typedef enum { I2S_EVENT_DMA_ERROR = 0, I2S_EVENT_TX_DONE, I2S_EVENT_RX_DONE, I2S_EVENT_TX_Q_OVF, I2S_EVENT_RX_Q_OVF } i2s_event_type_t;
+typedef struct {
+    i2s_event_type_t type;
+    size_t size;
+} i2s_event_t;
+
+typedef struct {
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+    i2s_mclk_multiple_t mclk_multiple;
+} i2s_config_t;
+
+/**
+ * @brief Fonte das amostras do ADC simulado (padrão: meia escala).
+ */
+int16_t hostAdcMid(adc1_channel_t) { return 2048; }
+int16_t (*hostAdcSample)(adc1_channel_t) = hostAdcMid;
+adc1_channel_t _hostAdcChannel = ADC1_CHANNEL_0;
+size_t hostI2sWritten = 0; ///< Bytes entregues a i2s_write().
+
+inline esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t *, int, QueueHandle_t *) { return ESP_OK; }
+inline esp_err_t i2s_driver_uninstall(i2s_port_t) { return ESP_OK; }
+inline esp_err_t i2s_set_adc_mode(adc_unit_t, adc1_channel_t channel) {
+    _hostAdcChannel = channel;
+    return ESP_OK;
+}
+inline esp_err_t i2s_adc_enable(i2s_port_t) { return ESP_OK; }
+inline esp_err_t i2s_set_dac_mode(i2s_dac_mode_t) { return ESP_OK; }
+inline esp_err_t i2s_read(i2s_port_t, void *dest, size_t size, size_t *bytes_read, TickType_t) {
+    int16_t *p = (int16_t *)dest;
+    for (size_t i = 0; i < size / sizeof(int16_t); i++) p[i] = hostAdcSample(_hostAdcChannel);
+    *bytes_read = size - size % sizeof(int16_t);
+    return ESP_OK;
+}
+inline esp_err_t i2s_write(i2s_port_t, const void *, size_t size, size_t *bytes_written, TickType_t) {
+    hostI2sWritten += size;
+    *bytes_written = size;
+    return ESP_OK;
+}
+inline void adc_power_acquire() {}
+inline esp_err_t adc1_config_width(adc_bits_width_t) { return ESP_OK; }
+inline esp_err_t adc1_config_channel_atten(adc1_channel_t, adc_atten_t) { return ESP_OK; }
+inline int adc1_get_raw(adc1_channel_t channel) { return hostAdcSample(channel); }
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file uart.h
+ * @brief Tipos do driver de UART usados pela biblioteca, para o build no host.
+ */
+
+#ifndef HOST_DRIVER_UART_H
+#define HOST_DRIVER_UART_H
+
+#include <esp_system.h>
+
+typedef int uart_port_t;
+
+inline esp_err_t uart_set_wakeup_threshold(uart_port_t, int) { return ESP_OK; }
+
+#endif
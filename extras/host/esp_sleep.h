@@ -0,0 +1,56 @@
+/**
+ * @file esp_sleep.h
+ * @brief Light sleep para o build no host: avança o relógio virtual até o despertar pelo timer.
+ *
+ * hostSleepWakeAt() permite simular um despertar por GPIO ou UART antes do fim do timer.
+ */
+
+#ifndef HOST_ESP_SLEEP_H
+#define HOST_ESP_SLEEP_H
+
+#include <Arduino.h>
+#include <esp_system.h>
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED = 0,
+    ESP_SLEEP_WAKEUP_TIMER = 4,
+    ESP_SLEEP_WAKEUP_GPIO = 7,
+    ESP_SLEEP_WAKEUP_UART = 8,
+} esp_sleep_wakeup_cause_t;
+
+uint64_t _hostSleepTimer = 0;                                        ///< Duração do timer de despertar (us).
+uint64_t _hostSleepWakeAt = 0;                                       ///< Despertar externo simulado (0 = nenhum).
+esp_sleep_wakeup_cause_t _hostSleepWakeCause = ESP_SLEEP_WAKEUP_GPIO; ///< Causa do despertar externo.
+esp_sleep_wakeup_cause_t _hostSleepCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+/**
+ * @brief Agenda um despertar externo no instante at (us do relógio virtual).
+ */
+inline void hostSleepWakeAt(uint64_t at, esp_sleep_wakeup_cause_t cause) {
+    _hostSleepWakeAt = at;
+    _hostSleepWakeCause = cause;
+}
+
+inline esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) {
+    _hostSleepTimer = us;
+    return ESP_OK;
+}
+inline esp_err_t esp_sleep_enable_gpio_wakeup(void) { return ESP_OK; }
+inline esp_err_t esp_sleep_enable_uart_wakeup(int) { return ESP_OK; }
+
+inline esp_err_t esp_light_sleep_start(void) {
+    const uint64_t end = _hostMicros + _hostSleepTimer;
+    if (_hostSleepWakeAt > _hostMicros && _hostSleepWakeAt < end) {
+        _hostMicros = _hostSleepWakeAt;
+        _hostSleepCause = _hostSleepWakeCause;
+        _hostSleepWakeAt = 0;
+    } else {
+        _hostMicros = end;
+        _hostSleepCause = ESP_SLEEP_WAKEUP_TIMER;
+    }
+    return ESP_OK;
+}
+
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) { return _hostSleepCause; }
+
+#endif
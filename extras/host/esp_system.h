@@ -0,0 +1,24 @@
+/**
+ * @file esp_system.h
+ * @brief Substituto de esp_system.h para o build no host.
+ */
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+/**
+ * @brief O host não tem MAC: retorna zeros, o que ativa o modo fallback de AdcDmaEsp.h.
+ */
+inline esp_err_t esp_read_mac(uint8_t *mac, int) {
+    memset(mac, 0, 6);
+    return ESP_OK;
+}
+
+#endif
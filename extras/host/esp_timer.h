@@ -0,0 +1,106 @@
+/**
+ * @file esp_timer.h
+ * @brief Substituto do esp_timer para o build no host.
+ *
+ * esp_timer_get_time() segue o relógio virtual. Os timers periódicos não disparam
+ * sozinhos: chame hostTimersRun() após avançar o relógio para executar os vencidos.
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <Arduino.h>
+#include <esp_system.h>
+
+typedef void (*esp_timer_cb_t)(void *arg);
+typedef enum { ESP_TIMER_TASK = 0, ESP_TIMER_ISR } esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    uint64_t period;    ///< 0 para disparo único.
+    uint64_t alarm;     ///< Próximo disparo (us).
+    bool armed;
+};
+typedef struct esp_timer *esp_timer_handle_t;
+
+#ifndef HOST_MAX_TIMERS
+#define HOST_MAX_TIMERS 8
+#endif
+
+struct esp_timer _hostTimers[HOST_MAX_TIMERS];
+uint8_t _hostTimerCount = 0;
+
+inline int64_t esp_timer_get_time() { return (int64_t)_hostMicros; }
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out) {
+    if (_hostTimerCount >= HOST_MAX_TIMERS) return ESP_FAIL;
+    esp_timer_handle_t t = &_hostTimers[_hostTimerCount++];
+    t->callback = args->callback;
+    t->arg = args->arg;
+    t->armed = false;
+    *out = t;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t period) {
+    t->period = period;
+    t->alarm = _hostMicros + period;
+    t->armed = true;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout) {
+    t->period = 0;
+    t->alarm = _hostMicros + timeout;
+    t->armed = true;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+    t->armed = false;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+    t->armed = false;
+    return ESP_OK;
+}
+
+/**
+ * @brief Retorna o instante (us) do próximo alarme armado, ou INT64_MAX se não houver.
+ */
+inline int64_t esp_timer_get_next_alarm() {
+    int64_t next = INT64_MAX;
+    for (uint8_t i = 0; i < _hostTimerCount; i++) {
+        if (_hostTimers[i].armed && (int64_t)_hostTimers[i].alarm < next) next = (int64_t)_hostTimers[i].alarm;
+    }
+    return next;
+}
+
+/**
+ * @brief Executa os timers vencidos no instante atual do relógio virtual.
+ * @return Número de callbacks executados.
+ */
+inline uint32_t hostTimersRun() {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < _hostTimerCount; i++) {
+        esp_timer &t = _hostTimers[i];
+        while (t.armed && t.alarm <= _hostMicros) {
+            const uint64_t now = _hostMicros;
+            _hostMicros = t.alarm; // O callback observa o instante nominal do disparo.
+            t.callback(t.arg);
+            _hostMicros = now;
+            n++;
+            if (t.period == 0) t.armed = false;
+            else t.alarm += t.period;
+        }
+    }
+    return n;
+}
+
+#endif
@@ -0,0 +1,11 @@
+/**
+ * @file esp_wifi.h
+ * @brief Substituto de esp_wifi.h para o build no host.
+ */
+
+#ifndef HOST_ESP_WIFI_H
+#define HOST_ESP_WIFI_H
+
+#define ESP_MAC_WIFI_STA 0
+
+#endif
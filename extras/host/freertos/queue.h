@@ -0,0 +1,98 @@
+/**
+ * @file queue.h
+ * @brief Filas e conjuntos de filas do FreeRTOS para o build no host.
+ *
+ * Tudo roda em uma única thread: xQueueSelectFromSet() com espera avança o relógio virtual
+ * até o próximo timer do esp_timer (executando-o) ou até o fim da espera, o que simula o
+ * loop dormindo sem gastar tempo real.
+ */
+
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "FreeRTOS.h"
+
+/**
+ * @brief Fila simulada (também usada para semáforos e conjuntos).
+ */
+struct HostQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::string> items;
+    std::vector<HostQueue *> members; ///< Membros, se for um conjunto.
+};
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue *q = new HostQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t handle, const void *item, TickType_t) {
+    HostQueue *q = (HostQueue *)handle;
+    if (q->items.size() >= q->length) return pdFALSE;
+    q->items.push_back(std::string((const char *)item, q->itemSize));
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueSendFromISR(QueueHandle_t handle, const void *item, BaseType_t *woken) {
+    if (woken != NULL) *woken = pdFALSE;
+    return xQueueSend(handle, item, 0);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t handle, void *item, TickType_t) {
+    HostQueue *q = (HostQueue *)handle;
+    if (q->items.empty()) return pdFALSE;
+    if (q->itemSize > 0 && item != NULL) memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t handle) {
+    ((HostQueue *)handle)->items.clear();
+    return pdPASS;
+}
+
+inline QueueSetHandle_t xQueueCreateSet(UBaseType_t length) {
+    return xQueueCreate(length, 0);
+}
+
+inline BaseType_t xQueueAddToSet(void *member, QueueSetHandle_t set) {
+    HostQueue *q = (HostQueue *)member;
+    if (!q->items.empty()) return pdFAIL;
+    ((HostQueue *)set)->members.push_back(q);
+    return pdPASS;
+}
+
+/**
+ * @brief Retorna o primeiro membro com itens, sem avançar o relógio.
+ */
+inline QueueSetMemberHandle_t hostSetReady(HostQueue *set) {
+    for (size_t i = 0; i < set->members.size(); i++) {
+        if (!set->members[i]->items.empty()) return set->members[i];
+    }
+    return NULL;
+}
+
+inline QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t handle, TickType_t ticks) {
+    HostQueue *set = (HostQueue *)handle;
+    const uint64_t end = _hostMicros + (uint64_t)ticks * 1000ULL * portTICK_PERIOD_MS;
+    for (;;) {
+        hostTimersRun();
+        QueueSetMemberHandle_t ready = hostSetReady(set);
+        if (ready != NULL || _hostMicros >= end) return ready;
+        uint64_t next = end;
+        for (uint8_t i = 0; i < _hostTimerCount; i++) {
+            if (_hostTimers[i].armed && _hostTimers[i].alarm < next) next = _hostTimers[i].alarm;
+        }
+        _hostMicros = next;
+    }
+}
+
+#endif
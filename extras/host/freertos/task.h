@@ -0,0 +1,58 @@
+/**
+ * @file task.h
+ * @brief Tarefas do FreeRTOS para o build no host.
+ *
+ * A criação de uma tarefa só a registra: nada roda em paralelo. O teste executa o corpo de
+ * uma tarefa registrada com hostTaskRun(), no ponto em que ela rodaria no kit.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include <Arduino.h>
+#include <string.h>
+#include <vector>
+#include "FreeRTOS.h"
+
+/**
+ * @brief Tarefa criada e ainda não executada por hostTaskRun().
+ */
+struct HostTask_t {
+    void (*fn)(void *);
+    void *arg;
+    const char *name;
+};
+
+inline std::vector<HostTask_t> &hostTasks() {
+    static std::vector<HostTask_t> tasks;
+    return tasks;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*fn)(void *), const char *name, uint32_t, void *arg, UBaseType_t, TaskHandle_t *handle, BaseType_t) {
+    if (handle != NULL) *handle = NULL;
+    HostTask_t t = {fn, arg, name};
+    hostTasks().push_back(t);
+    return pdPASS;
+}
+inline void vTaskDelete(TaskHandle_t) {}
+inline void vTaskDelay(TickType_t ticks) { _hostMicros += (uint64_t)ticks * 1000ULL; }
+
+/**
+ * @brief Executa até o fim a tarefa registrada com esse nome (só serve para tarefas que
+ * terminam, como a de inicialização).
+ * @return false se nenhuma tarefa pendente tiver esse nome.
+ */
+inline bool hostTaskRun(const char *name) {
+    std::vector<HostTask_t> &tasks = hostTasks();
+    for (size_t i = 0; i < tasks.size(); i++) {
+        if (strcmp(tasks[i].name, name) == 0) {
+            const HostTask_t t = tasks[i];
+            tasks.erase(tasks.begin() + i);
+            t.fn(t.arg);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
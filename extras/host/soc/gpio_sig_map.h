@@ -0,0 +1,13 @@
+/**
+ * @file gpio_sig_map.h
+ * @brief Índices de sinais do GPIO matrix usados pela biblioteca, para o build no host.
+ */
+
+#ifndef HOST_SOC_GPIO_SIG_MAP_H
+#define HOST_SOC_GPIO_SIG_MAP_H
+
+#define LEDC_HS_SIG_OUT0_IDX 71 ///< Saída do canal 0 do LEDC de alta velocidade (+1 por canal).
+#define LEDC_LS_SIG_OUT0_IDX 79 ///< Saída do canal 0 do LEDC de baixa velocidade (+1 por canal).
+#define SIG_GPIO_OUT_IDX 256    ///< Nenhum periférico: o pino segue o registrador de saída do GPIO.
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file gpio_struct.h
+ * @brief Registradores de GPIO para o build no host, ligados ao GPIO simulado de Arduino.h.
+ *
+ * Escritas em out_w1ts / out_w1tc (e out1_*.val) alteram _hostPinLevel; leituras de in
+ * (e in1.val) montam a máscara a partir dele, então gpioFast.h e digitalRead() concordam.
+ */
+
+#ifndef HOST_SOC_GPIO_STRUCT_H
+#define HOST_SOC_GPIO_STRUCT_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Registrador de escrita: cada bit 1 da máscara leva o pino correspondente a level.
+ */
+struct HostGpioSet {
+    uint8_t base;
+    uint8_t level;
+    HostGpioSet &operator=(uint32_t mask) {
+        for (uint8_t i = 0; i < 32 && base + i < 40; i++) {
+            if (mask & (1UL << i)) _hostPinLevel[base + i] = level;
+        }
+        return *this;
+    }
+};
+
+/**
+ * @brief Registrador de leitura dos níveis dos pinos base a base + 31.
+ */
+struct HostGpioIn {
+    uint8_t base;
+    operator uint32_t() const {
+        uint32_t v = 0;
+        for (uint8_t i = 0; i < 32 && base + i < 40; i++) {
+            if (_hostPinLevel[base + i]) v |= 1UL << i;
+        }
+        return v;
+    }
+};
+
+/**
+ * @brief Configuração de saída de um pino no GPIO matrix (só o sinal selecionado).
+ */
+struct HostGpioOutSel {
+    uint32_t func_sel;
+};
+
+/**
+ * @brief func_out_sel_cfg[pin]: leitura do sinal ligado ao pino em _hostPinSignal.
+ */
+struct HostGpioOutSelArray {
+    HostGpioOutSel operator[](uint8_t pin) const {
+        HostGpioOutSel s = {pin < 40 ? _hostPinSignal.sig[pin] : 256U};
+        return s;
+    }
+};
+
+struct HostGpioDev {
+    HostGpioSet out_w1ts;
+    HostGpioSet out_w1tc;
+    struct { HostGpioSet val; } out1_w1ts;
+    struct { HostGpioSet val; } out1_w1tc;
+    HostGpioIn in;
+    struct { HostGpioIn val; } in1;
+    HostGpioOutSelArray func_out_sel_cfg;
+};
+
+HostGpioDev GPIO = {{0, 1}, {0, 0}, {{32, 1}}, {{32, 0}}, {0}, {{32}}, {}};
+
+#endif
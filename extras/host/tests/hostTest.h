@@ -0,0 +1,71 @@
+/**
+ * @file hostTest.h
+ * @brief Verificações mínimas para os testes de unidade no host (ctest).
+ *
+ * Cada teste é um programa: as funções de teste usam HOST_CHECK/HOST_CHECK_EQ/
+ * HOST_CHECK_NEAR, que apenas registram a falha (com arquivo e linha) e seguem, e main()
+ * retorna hostTestResult(), diferente de zero se alguma verificação falhou.
+ *
+ * Uso:
+ * @code
+ * #include "iikitmini.h"
+ * #include "hostTest.h"
+ * void testSoma() { HOST_CHECK_EQ(1 + 1, 2); }
+ * int main() {
+ *     HOST_RUN(testSoma);
+ *     return hostTestResult();
+ * }
+ * @endcode
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+uint32_t _hostTestChecks = 0;   ///< Verificações executadas.
+uint32_t _hostTestFailures = 0; ///< Verificações que falharam.
+
+/**
+ * @brief Registra o resultado de uma verificação.
+ */
+inline void _hostTestCheck(bool ok, const char *expr, const char *file, int line) {
+    _hostTestChecks++;
+    if (ok) return;
+    _hostTestFailures++;
+    printf("%s:%d: falhou: %s\n", file, line, expr);
+}
+
+#define HOST_CHECK(cond) _hostTestCheck((cond), #cond, __FILE__, __LINE__)
+#define HOST_CHECK_EQ(a, b)                                                                      \
+    do {                                                                                         \
+        const long long _a = (long long)(a), _b = (long long)(b);                                \
+        _hostTestCheck(_a == _b, #a " == " #b, __FILE__, __LINE__);                              \
+        if (_a != _b) printf("    %lld != %lld\n", _a, _b);                                      \
+    } while (0)
+#define HOST_CHECK_NEAR(a, b, tol)                                                               \
+    do {                                                                                         \
+        const double _a = (double)(a), _b = (double)(b);                                         \
+        _hostTestCheck(fabs(_a - _b) <= (tol), #a " ~= " #b, __FILE__, __LINE__);                \
+        if (fabs(_a - _b) > (tol)) printf("    %.6f != %.6f (tol %.6f)\n", _a, _b, (double)(tol)); \
+    } while (0)
+
+/**
+ * @brief Executa uma função de teste e informa o nome.
+ */
+#define HOST_RUN(fn)            \
+    do {                        \
+        printf("- %s\n", #fn);  \
+        fn();                   \
+    } while (0)
+
+/**
+ * @brief Resume as verificações e retorna o código de saída do programa.
+ */
+inline int hostTestResult() {
+    printf("%u verificacoes, %u falhas\n", _hostTestChecks, _hostTestFailures);
+    return _hostTestFailures == 0 ? 0 : 1;
+}
+
+#endif
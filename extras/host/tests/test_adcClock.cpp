@@ -0,0 +1,86 @@
+/**
+ * @file test_adcClock.cpp
+ * @brief Base de tempo comum: blocos da fonte sintética do ADC, canal sintético do ADS1115
+ * e borda de uma entrada digital veem o mesmo degrau no mesmo instante do esp_timer.
+ */
+
+#include "util/AdcDmaEsp.h"
+#include "services/ads1115_c.h"
+#include "util/dinDebounce.h"
+#include "hostTest.h"
+
+#define PERIOD 1000   ///< Período de amostragem do ADC (us).
+#define BLOCK 100     ///< Amostras por callback.
+#define STEP_AT 5234567ULL ///< Instante (us, esp_timer) do degrau.
+
+int16_t samples[BLOCK];
+uint64_t blockT0 = 0;
+uint32_t blocks = 0;
+
+void onBlock(const int16_t *data, size_t count) {
+    HOST_CHECK_EQ(count, BLOCK);
+    memcpy(samples, data, count * sizeof(int16_t));
+    blockT0 = adcDmaLastTime();
+    blocks++;
+}
+
+/**
+ * @brief Índice da primeira amostra do bloco com o degrau, ou -1.
+ */
+int stepIndex() {
+    for (int i = 0; i < BLOCK; i++) {
+        if (samples[i] != 0) return i;
+    }
+    return -1;
+}
+
+void testCrossSourceAlignment() {
+    SignalSource_c sig;
+    sig.range(0, 32767).step(1000, STEP_AT);
+    // O kit já está ligado há 5 s quando a fonte é trocada.
+    hostClockSet(5000000ULL);
+    adcDmaSetup(CHANNEL_ADC1, PERIOD, onBlock, BLOCK * PERIOD);
+    adcDmaSetSource(&sig);
+
+    // Primeiro bloco: a última amostra corresponde ao instante da leitura.
+    hostClockAdvance(BLOCK * PERIOD);
+    adcDmaLoop();
+    HOST_CHECK_EQ(blocks, 1);
+    HOST_CHECK_EQ(blockT0 + (BLOCK - 1) * PERIOD, _hostMicros);
+    HOST_CHECK_EQ(stepIndex(), -1);
+
+    // O degrau cai no terceiro bloco, na primeira amostra em t >= STEP_AT.
+    uint64_t prevT0 = blockT0;
+    for (int b = 0; b < 2; b++) {
+        hostClockAdvance(BLOCK * PERIOD);
+        adcDmaLoop();
+        HOST_CHECK_EQ(blockT0, prevT0 + BLOCK * PERIOD); // Blocos contíguos.
+        prevT0 = blockT0;
+    }
+    const int k = stepIndex();
+    HOST_CHECK(k > 0);
+    const uint64_t adcEdge = blockT0 + (uint64_t)k * PERIOD;
+    HOST_CHECK(adcEdge >= STEP_AT && adcEdge < STEP_AT + PERIOD);
+
+    // O ADS1115 lê a mesma fonte no instante do esp_timer.
+    ADS1115_c ads;
+    ads.setSource(0, &sig);
+    hostClockSet(STEP_AT - 1);
+    HOST_CHECK_EQ(ads.analogRead(0), 0);
+    hostClockSet(STEP_AT);
+    HOST_CHECK_EQ(ads.analogRead(0), 1000);
+
+    // E a entrada digital registra a borda no mesmo relógio.
+    DigitalINDebounce din(4, 0);
+    din.update();
+    hostPinSet(4, HIGH);
+    din.update();
+    HOST_CHECK(din.pinValue());
+    HOST_CHECK_EQ(din.edgeTime(), STEP_AT);
+    HOST_CHECK(adcEdge - din.edgeTime() < PERIOD);
+}
+
+int main() {
+    HOST_RUN(testCrossSourceAlignment);
+    return hostTestResult();
+}
@@ -0,0 +1,86 @@
+/**
+ * @file test_ads1115.cpp
+ * @brief Varredura não bloqueante do ADS1115: prazos de nextDue(), conversão atrasada e
+ * chip que para de responder no meio da varredura (abandono, espera crescente e retomada).
+ */
+
+#include "services/ads1115_c.h"
+#include "hostTest.h"
+
+#define CONV_US (1000000UL / 860 + 100) ///< Duração estimada de uma conversão a 860 SPS.
+
+/**
+ * @brief Simula o loop de eventos por duration us: dorme até nextDue() e chama scan().
+ * @return Número de chamadas de scan().
+ */
+uint32_t runLoop(ADS1115_c &ads, uint64_t duration) {
+    const uint64_t end = _hostMicros + duration;
+    uint32_t calls = 0;
+    while (_hostMicros < end) {
+        const uint32_t due = ads.nextDue();
+        hostClockAdvance(due > 0 ? min((uint64_t)due, end - _hostMicros) : 1);
+        ads.scan();
+        calls++;
+    }
+    return calls;
+}
+
+void testScan() {
+    hostClockSet(1000000);
+    ADS1115_c ads;
+    HOST_CHECK(ads.begin());
+    for (int i = 0; i < 4; i++) hostAdsValue[i] = (int16_t)(100 * (i + 1));
+    ads.startScan(RATE_ADS1115_860SPS);
+    HOST_CHECK_EQ(ads.nextDue(), CONV_US);
+    hostClockAdvance(CONV_US);
+    HOST_CHECK_EQ(ads.nextDue(), 0);
+    ads.scan();
+    HOST_CHECK_EQ(ads.sampleCount(0), 1);
+    HOST_CHECK_EQ(ads.analogRead(0), 100);
+    // Um segundo de loop: uma chamada de scan() por conversão.
+    const uint32_t calls = runLoop(ads, 1000000);
+    HOST_CHECK_NEAR(calls, 1000000 / CONV_US, 2);
+    HOST_CHECK_EQ(ads.analogRead(3), 400);
+    HOST_CHECK_EQ(ads.timeouts(), 0);
+}
+
+void testChipStopsAnswering() {
+    hostClockSet(5000000);
+    ADS1115_c ads;
+    HOST_CHECK(ads.begin());
+    hostAdsValue[0] = 1234;
+    ads.startScan(RATE_ADS1115_860SPS);
+    runLoop(ads, 100000);
+    const uint32_t seq = ads.sampleCount(0);
+    HOST_CHECK(seq > 0);
+    // O chip para de responder: a conversão atrasada é consultada a cada 1/4 de conversão
+    // e abandonada após ADS1115_SCAN_TIMEOUT conversões, sem girar o loop.
+    hostAdsResponding = false;
+    const uint32_t calls = runLoop(ads, 3000000);
+    HOST_CHECK(calls < 100);
+    HOST_CHECK_EQ(ads.sampleCount(0), seq);
+    HOST_CHECK_EQ(ads.analogRead(0), 1234); // O cache continua com o último valor.
+    // Esperas de 100, 200, 400, 800 e 1000 ms: a sexta conversão é abandonada em ~2,5 s e a
+    // espera seguinte continua limitada a 1 s.
+    HOST_CHECK_EQ(ads.timeouts(), 6);
+    HOST_CHECK(ads.nextDue() > 0 && ads.nextDue() <= ADS1115_SCAN_BACKOFF_MAX_US);
+    // O chip volta: a varredura é retomada no fim da espera corrente.
+    hostAdsResponding = true;
+    hostAdsValue[0] = 4321;
+    runLoop(ads, ADS1115_SCAN_BACKOFF_MAX_US + 10 * CONV_US);
+    HOST_CHECK(ads.sampleCount(0) > seq);
+    HOST_CHECK_EQ(ads.analogRead(0), 4321);
+    // A espera volta ao valor inicial depois de uma conversão bem-sucedida.
+    hostAdsResponding = false;
+    const uint32_t before = ads.timeouts();
+    runLoop(ads, ADS1115_SCAN_TIMEOUT * CONV_US + ADS1115_SCAN_BACKOFF_US / 2);
+    HOST_CHECK_EQ(ads.timeouts(), before + 1);
+    HOST_CHECK(ads.nextDue() <= ADS1115_SCAN_BACKOFF_US);
+    hostAdsResponding = true;
+}
+
+int main() {
+    HOST_RUN(testScan);
+    HOST_RUN(testChipStopsAnswering);
+    return hostTestResult();
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_dacWave.cpp
+ * @brief Gerador DDS dos DACs: frequência, troca de tabela só no fim do ciclo e devolução de
+ * GPIO26 ao LEDC da saída 4-20mA.
+ *
+ * A tarefa que alimenta o I2S não roda no host; as amostras são geradas chamando
+ * dacWaveNext() diretamente.
+ */
+
+#include "util/DacWaveEsp.h"
+#include "util/ledcOut.h"
+#include "hostTest.h"
+
+#define RATE 100000UL
+
+void testFrequency() {
+    HOST_CHECK(dacWaveSetup(true, false, RATE));
+    DacWaveChannel_t &ch = _dacWave[DAC_WAVE_CH_DAC1];
+    dacWaveFrequency(DAC_WAVE_CH_DAC1, 1000.0);
+    HOST_CHECK_EQ(ch.increment, 42949672UL); // 2^32 * 1000 / 100000.
+    // Um segundo de amostras: 1000 ciclos completos do acumulador de fase.
+    uint32_t cycles = 0;
+    for (uint32_t i = 0; i < RATE; i++) {
+        const uint32_t prev = ch.phase;
+        dacWaveNext(ch);
+        if (ch.phase < prev) cycles++;
+    }
+    HOST_CHECK_NEAR(cycles, 1000, 1);
+    // Resolução de sampleRate / 2^32: 0.001 Hz ainda avança a fase.
+    dacWaveFrequency(DAC_WAVE_CH_DAC1, 0.001);
+    HOST_CHECK_EQ(ch.increment, 42);
+    dacWaveStop();
+}
+
+void testSineTable() {
+    HOST_CHECK(dacWaveSetup(true, false, RATE));
+    DacWaveChannel_t &ch = _dacWave[DAC_WAVE_CH_DAC1];
+    // Canal parado: a tabela nova entra já na próxima amostra.
+    dacWaveSine(DAC_WAVE_CH_DAC1, 100, 128);
+    HOST_CHECK_EQ(dacWaveNext(ch), 128); // sin(0).
+    HOST_CHECK(!ch.pending);
+    dacWaveFrequency(DAC_WAVE_CH_DAC1, (double)RATE / 4); // Um quarto de ciclo por amostra.
+    HOST_CHECK_EQ(dacWaveNext(ch), 228);
+    HOST_CHECK_EQ(dacWaveNext(ch), 128);
+    HOST_CHECK_EQ(dacWaveNext(ch), 28);
+    dacWaveStop();
+}
+
+void testTableSwapAtCycleEnd() {
+    HOST_CHECK(dacWaveSetup(true, false, RATE));
+    DacWaveChannel_t &ch = _dacWave[DAC_WAVE_CH_DAC1];
+    dacWaveRamp(DAC_WAVE_CH_DAC1, 100, 128);
+    dacWaveNext(ch);
+    dacWaveFrequency(DAC_WAVE_CH_DAC1, 1000.0); // 100 amostras por ciclo.
+    for (int i = 0; i < 30; i++) dacWaveNext(ch);
+    // Quadrada carregada no meio do ciclo: a rampa continua subindo até o fim dele.
+    dacWaveSquare(DAC_WAVE_CH_DAC1, 100, 128);
+    HOST_CHECK(ch.pending);
+    uint8_t prev = 0;
+    int n = 0;
+    while (ch.pending) {
+        const uint8_t v = dacWaveNext(ch);
+        if (!ch.pending) break;
+        HOST_CHECK(v >= prev);
+        prev = v;
+        n++;
+    }
+    HOST_CHECK_NEAR(n, 69, 1);
+    // Ciclo seguinte: só os dois níveis da quadrada.
+    for (int i = 0; i < 100; i++) {
+        const uint8_t v = dacWaveNext(ch);
+        HOST_CHECK(v == 228 || v == 28);
+    }
+    dacWaveStop();
+}
+
+void testPin26SharedWithLedc() {
+    LedcOut_c out4a20;
+    HOST_CHECK(out4a20.begin(DAC_WAVE_PIN_4A20, LEDC_CHANNEL_1, LEDC_TIMER_1, 1000, 16));
+    HOST_CHECK_EQ(GPIO.func_out_sel_cfg[DAC_WAVE_PIN_4A20].func_sel, LEDC_HS_SIG_OUT0_IDX + 1);
+    // Só DAC1: GPIO26 continua com o LEDC.
+    HOST_CHECK(dacWaveSetup(true, false, RATE));
+    HOST_CHECK_EQ(GPIO.func_out_sel_cfg[DAC_WAVE_PIN_4A20].func_sel, LEDC_HS_SIG_OUT0_IDX + 1);
+    dacWaveStop();
+    // DAC2: o LEDC sai do pino e o driver digital é desligado até dacWaveStop().
+    HOST_CHECK(dacWaveSetup(false, true, RATE));
+    HOST_CHECK_EQ(GPIO.func_out_sel_cfg[DAC_WAVE_PIN_4A20].func_sel, SIG_GPIO_OUT_IDX);
+    HOST_CHECK_EQ(_hostPinMode[DAC_WAVE_PIN_4A20], INPUT);
+    dacWaveStop();
+    HOST_CHECK_EQ(GPIO.func_out_sel_cfg[DAC_WAVE_PIN_4A20].func_sel, LEDC_HS_SIG_OUT0_IDX + 1);
+    HOST_CHECK_EQ(_hostPinMode[DAC_WAVE_PIN_4A20], OUTPUT);
+}
+
+int main() {
+    HOST_RUN(testFrequency);
+    HOST_RUN(testSineTable);
+    HOST_RUN(testTableSwapAtCycleEnd);
+    HOST_RUN(testPin26SharedWithLedc);
+    return hostTestResult();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_hartPoll.cpp
+ * @brief Escalonador HART: identificação e leitura do cache, espera presa à resposta do
+ * comando enviado, dispositivos em burst mode e prazo de períodos longos.
+ *
+ * As respostas dos escravos são colocadas diretamente na entrada de Serial2.
+ */
+
+#include "util/hartPoll.h"
+#include "hostTest.h"
+
+#define MANUF 0x26  ///< Fabricante dos dispositivos simulados.
+#define DEVTYPE 0x07
+
+/**
+ * @brief Coloca na entrada do modem um frame de escravo (ACK ou BACK) com endereço longo.
+ */
+void slaveFrame(uint8_t type, uint8_t serial, bool burst, uint8_t command, const uint8_t *data, uint8_t len) {
+    const uint8_t addr[5] = {(uint8_t)(0x80 | (burst ? 0x40 : 0) | MANUF), DEVTYPE, 0, 0, serial};
+    uint8_t out[64];
+    const size_t n = hartBuildRequest(out, addr, 5, command, data, len);
+    out[5] = type | HART_DELIM_LONG;
+    out[n - 1] ^= HART_DELIM_STX ^ type; // Checksum com o delimitador trocado.
+    Serial2.rx.append((const char *)out, n);
+}
+
+/**
+ * @brief Resposta ao comando 0 (identificação) pelo endereço curto pollAddr.
+ */
+void reply0(uint8_t pollAddr, uint8_t serial) {
+    uint8_t data[14] = {0, 0, 254, MANUF, DEVTYPE, 5, 5, 1, 1, 1, 0, 0, 0, serial};
+    const uint8_t addr = 0x80 | pollAddr;
+    uint8_t out[64];
+    const size_t n = hartBuildRequest(out, &addr, 1, 0, data, sizeof(data));
+    out[5] = HART_DELIM_ACK;
+    out[n - 1] ^= HART_DELIM_STX ^ HART_DELIM_ACK;
+    Serial2.rx.append((const char *)out, n);
+}
+
+/**
+ * @brief Frame do comando 3 com corrente de 12 mA e PV em kPa (unidade 12).
+ */
+void frame3(uint8_t type, uint8_t serial, bool burst, float pv) {
+    uint8_t data[11] = {0, 0, 0x41, 0x40, 0x00, 0x00, 12};
+    uint32_t raw;
+    memcpy(&raw, &pv, 4);
+    for (int i = 0; i < 4; i++) data[7 + i] = (uint8_t)(raw >> (24 - 8 * i));
+    slaveFrame(type, serial, burst, 3, data, sizeof(data));
+}
+
+/**
+ * @brief Comando da última requisição enviada ao modem, ou -1 se nada foi enviado.
+ */
+int lastCommand() {
+    if (Serial2.tx.empty()) return -1;
+    const std::string &tx = Serial2.tx;
+    const uint8_t delim = (uint8_t)tx[tx.rfind('\xff') + 1];
+    const size_t at = tx.rfind('\xff') + 1 + 1 + ((delim & HART_DELIM_LONG) ? 5 : 1);
+    return (uint8_t)tx[at];
+}
+
+/**
+ * @brief Identifica o dispositivo handle e lê suas variáveis uma vez.
+ */
+void bringUp(HartPoll_c &hart, uint8_t pollAddr, uint8_t serial, float pv) {
+    Serial2.tx.clear();
+    hart.update();
+    HOST_CHECK_EQ(lastCommand(), 0);
+    reply0(pollAddr, serial);
+    Serial2.tx.clear();
+    hart.update();
+    HOST_CHECK_EQ(lastCommand(), 3);
+    frame3(HART_DELIM_ACK, serial, false, pv);
+    hart.update();
+}
+
+void testPollAndCache() {
+    hostClockSet(1000000);
+    HartPoll_c hart;
+    hart.begin();
+    const int8_t a = hart.addDevice(1, 1000);
+    bringUp(hart, 1, 0x11, 12.5f);
+    HOST_CHECK(hart.device(a)->identified);
+    HOST_CHECK_NEAR(hart.pv(a), 12.5, 1e-6);
+    HOST_CHECK_NEAR(hart.vars(a)->current, 12.0, 1e-6);
+    HOST_CHECK_EQ(hart.vars(a)->units[0], 12);
+    HOST_CHECK_EQ(hart.age(a), 0);
+    // Cache novo: nada a enviar até o período vencer.
+    HOST_CHECK_EQ(hart.nextDue(), 1000000UL);
+}
+
+void testWaitEndsOnlyOnMatchingReply() {
+    hostClockSet(2000000);
+    Serial2.rx.clear();
+    Serial2.rxPos = 0;
+    HartPoll_c hart;
+    hart.begin();
+    const int8_t a = hart.addDevice(1, 1000);
+    const int8_t b = hart.addDevice(2, 1000);
+    // Identificação dos dois e primeira leitura de cada um.
+    hart.update();
+    reply0(1, 0x11);
+    hart.update();
+    reply0(2, 0x22);
+    hart.update();
+    frame3(HART_DELIM_ACK, 0x22, false, 1.0f);
+    hart.update();
+    hostClockAdvance(100000);
+    frame3(HART_DELIM_ACK, 0x11, false, 1.0f);
+    hart.update();
+    HOST_CHECK(hart.device(b)->identified);
+    HOST_CHECK(hart.vars(a)->valid && hart.vars(b)->valid);
+    // Dispositivo 2, o mais atrasado, recebe o comando 3.
+    hostClockAdvance(1000000);
+    Serial2.tx.clear();
+    hart.update();
+    HOST_CHECK_EQ(lastCommand(), 3);
+    // Resposta do dispositivo 2 a outro comando (outro mestre) e um burst dele: o cache é
+    // atualizado pelo burst, mas a espera continua e o dispositivo 1 não é interrogado.
+    reply0(2, 0x22);
+    frame3(HART_DELIM_BACK, 0x22, true, 2.0f);
+    hostClockAdvance(10000);
+    Serial2.tx.clear();
+    hart.update();
+    HOST_CHECK(Serial2.tx.empty());
+    HOST_CHECK_NEAR(hart.pv(b), 2.0, 1e-6);
+    HOST_CHECK(hart.nextDue() > 0 && hart.nextDue() <= HART_RESPONSE_TIMEOUT * 1000UL);
+    // A resposta ao comando 3 libera o barramento.
+    frame3(HART_DELIM_ACK, 0x22, false, 3.0f);
+    hostClockAdvance(10000);
+    hart.update();
+    HOST_CHECK_EQ(lastCommand(), 3); // Dispositivo 1, que também venceu.
+    HOST_CHECK_NEAR(hart.pv(b), 3.0, 1e-6);
+    HOST_CHECK_EQ(hart.device(b)->failures, 0);
+}
+
+void testBurstDeviceNotPolled() {
+    hostClockSet(10000000);
+    Serial2.rx.clear();
+    Serial2.rxPos = 0;
+    HartPoll_c hart;
+    hart.begin();
+    const int8_t a = hart.addDevice(1, 1000);
+    bringUp(hart, 1, 0x11, 1.0f);
+    // Frame de burst: o dispositivo passa a renovar o próprio cache.
+    frame3(HART_DELIM_BACK, 0x11, true, 4.0f);
+    hart.update();
+    HOST_CHECK(hart.device(a)->burst);
+    HOST_CHECK_EQ(hart.nextDue(), HART_BURST_GRACE * 1000000UL);
+    // Um período sem bursts ainda não gera requisição.
+    hostClockAdvance(1500000);
+    Serial2.tx.clear();
+    hart.update();
+    HOST_CHECK(Serial2.tx.empty());
+    // Burst interrompido por HART_BURST_GRACE períodos: volta a ser interrogado.
+    hostClockAdvance(HART_BURST_GRACE * 1000000UL - 1500000);
+    HOST_CHECK_EQ(hart.nextDue(), 0);
+    hart.update();
+    HOST_CHECK_EQ(lastCommand(), 3);
+    // A resposta sem o bit de burst devolve o período normal.
+    frame3(HART_DELIM_ACK, 0x11, false, 5.0f);
+    hart.update();
+    HOST_CHECK(!hart.device(a)->burst);
+    HOST_CHECK_EQ(hart.nextDue(), 1000000UL);
+}
+
+void testLongPeriod() {
+    hostClockSet(20000000);
+    Serial2.rx.clear();
+    Serial2.rxPos = 0;
+    HartPoll_c hart;
+    hart.begin();
+    hart.addDevice(1, 5UL * 3600UL * 1000UL); // 5 h: 1.8e10 us não cabe em 32 bits.
+    bringUp(hart, 1, 0x11, 1.0f);
+    HOST_CHECK_EQ(hart.nextDue(), UINT32_MAX);
+    hostClockAdvance((5ULL * 3600ULL - 60ULL) * 1000000ULL);
+    HOST_CHECK_EQ(hart.nextDue(), 60000000UL);
+}
+
+int main() {
+    HOST_RUN(testPollAndCache);
+    HOST_RUN(testWaitEndsOnlyOnMatchingReply);
+    HOST_RUN(testBurstDeviceNotPolled);
+    HOST_RUN(testLongPeriod);
+    return hostTestResult();
+}
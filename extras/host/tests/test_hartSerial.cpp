@@ -0,0 +1,95 @@
+/**
+ * @file test_hartSerial.cpp
+ * @brief Parser de frames HART: requisição montada e relida, checksum, endereço longo e limites.
+ */
+
+#include "util/hartSerial.h"
+#include "hostTest.h"
+
+HartFrameParser parser;
+
+/**
+ * @brief Entrega o buffer ao parser e conta os frames válidos.
+ */
+int feed(const uint8_t *p, size_t n) {
+    int frames = 0;
+    for (size_t i = 0; i < n; i++) frames += parser.parse(p[i]) ? 1 : 0;
+    return frames;
+}
+
+void testShortRequestRoundTrip() {
+    parser.reset();
+    uint8_t out[64];
+    const uint8_t addr = 0x80;
+    const size_t n = hartBuildRequest(out, &addr, 1, 0);
+    HOST_CHECK_EQ(feed(out, n), 1);
+    const HartFrame_t &f = parser.frame();
+    HOST_CHECK_EQ(f.delimiter & 0x07, HART_DELIM_STX);
+    HOST_CHECK_EQ(f.addrLen, 1);
+    HOST_CHECK_EQ(f.addr[0], 0x80);
+    HOST_CHECK_EQ(f.command, 0);
+    HOST_CHECK_EQ(f.byteCount, 0);
+}
+
+void testLongAckWithFloat() {
+    parser.reset();
+    // Resposta ao comando 1: status (2 bytes), unidade e PV = 12.5 (0x41480000).
+    const uint8_t frame[] = {0xFF, 0xFF, 0xFF, 0x86, 0xA6, 0x01, 0x02, 0x03, 0x04, 0x01, 0x07,
+                             0x00, 0x00, 0x20, 0x41, 0x48, 0x00, 0x00, 0x00};
+    uint8_t raw[sizeof(frame)];
+    memcpy(raw, frame, sizeof(frame));
+    uint8_t checksum = 0;
+    for (size_t i = 3; i < sizeof(raw) - 1; i++) checksum ^= raw[i];
+    raw[sizeof(raw) - 1] = checksum;
+    HOST_CHECK_EQ(feed(raw, sizeof(raw)), 1);
+    const HartFrame_t &f = parser.frame();
+    HOST_CHECK_EQ(f.addrLen, 5);
+    HOST_CHECK_EQ(f.addr[4], 0x04);
+    HOST_CHECK_EQ(f.command, 1);
+    HOST_CHECK_EQ(f.byteCount, 7);
+    HOST_CHECK_EQ(f.data[2], 0x20);
+    HOST_CHECK_NEAR(hartGetFloat(&f.data[3]), 12.5, 1e-6);
+}
+
+void testBadChecksum() {
+    parser.reset();
+    uint8_t out[64];
+    const uint8_t addr = 0x81;
+    const size_t n = hartBuildRequest(out, &addr, 1, 3);
+    out[n - 1] ^= 0x55;
+    HOST_CHECK_EQ(feed(out, n), 0);
+    // O parser volta a esperar o preâmbulo e aceita o frame seguinte.
+    out[n - 1] ^= 0x55;
+    HOST_CHECK_EQ(feed(out, n), 1);
+}
+
+void testOversizedFrame() {
+    parser.reset();
+    uint8_t raw[] = {0xFF, 0xFF, 0x06, 0x80, 0x01, HART_MAX_DATA + 1};
+    HOST_CHECK_EQ(feed(raw, sizeof(raw)), 0);
+    // Frame válido logo depois do rejeitado.
+    uint8_t out[64];
+    const uint8_t addr = 0x80;
+    const size_t n = hartBuildRequest(out, &addr, 1, 1);
+    HOST_CHECK_EQ(feed(out, n), 1);
+    HOST_CHECK_EQ(parser.frame().command, 1);
+}
+
+void testNoiseBeforeFrame() {
+    parser.reset();
+    const uint8_t noise[] = {0x00, 0xFF, 0x12, 0xFF, 0x07, 0x33};
+    HOST_CHECK_EQ(feed(noise, sizeof(noise)), 0);
+    uint8_t out[64];
+    const uint8_t addr = 0x80;
+    const size_t n = hartBuildRequest(out, &addr, 1, 2);
+    HOST_CHECK_EQ(feed(out, n), 1);
+}
+
+int main() {
+    HOST_RUN(testShortRequestRoundTrip);
+    HOST_RUN(testLongAckWithFloat);
+    HOST_RUN(testBadChecksum);
+    HOST_RUN(testOversizedFrame);
+    HOST_RUN(testNoiseBeforeFrame);
+    return hostTestResult();
+}
@@ -0,0 +1,115 @@
+/**
+ * @file test_iikitConfig.cpp
+ * @brief Configuração persistente: análise do texto dos comandos, regras entre parâmetros e
+ * blob na NVS (CRC, versão e faixa).
+ */
+
+#include "util/iikitConfig.h"
+#include "hostTest.h"
+
+void testParse() {
+    uint8_t bits = 12;
+    HOST_CHECK(configParse<uint8_t>(bits, "16", 1, 16));
+    HOST_CHECK_EQ(bits, 16);
+    // Texto que não é número, ou não é só número, não vira 0 nem é truncado.
+    HOST_CHECK(!configParse<uint8_t>(bits, "abc", 0, 16));
+    HOST_CHECK(!configParse<uint8_t>(bits, "", 0, 16));
+    HOST_CHECK(!configParse<uint8_t>(bits, "8x", 0, 16));
+    HOST_CHECK(!configParse<uint8_t>(bits, "12.5", 0, 16));
+    HOST_CHECK(!configParse<uint8_t>(bits, "1e1", 0, 16));
+    HOST_CHECK(!configParse<uint8_t>(bits, "17", 0, 16));
+    HOST_CHECK(!configParse<uint8_t>(bits, "-1", 0, 16));
+    HOST_CHECK_EQ(bits, 16);
+    uint32_t baud = 0;
+    HOST_CHECK(!configParse<uint32_t>(baud, "99999999999999999999", 1200, 2000000));
+    HOST_CHECK(configParse<uint32_t>(baud, "2000000", 1200, 2000000));
+    HOST_CHECK_EQ(baud, 2000000);
+    float cal = 0.2f;
+    HOST_CHECK(configParse<float>(cal, "0.25", 0.0f, 1.0f));
+    HOST_CHECK_NEAR(cal, 0.25, 1e-6);
+    HOST_CHECK(configParse<float>(cal, "1e-1", 0.0f, 1.0f));
+    HOST_CHECK_NEAR(cal, 0.1, 1e-6);
+    HOST_CHECK(!configParse<float>(cal, "nan", 0.0f, 1.0f));
+    HOST_CHECK(!configParse<float>(cal, "0.5V", 0.0f, 1.0f));
+    HOST_CHECK_NEAR(cal, 0.1, 1e-6);
+}
+
+void testCommand() {
+    configDefaults();
+    Serial.tx.clear();
+    configCommand(Serial, "debounceMs x");
+    HOST_CHECK(Serial.tx.find("cfg: valor invalido debounceMs=50") != std::string::npos);
+    HOST_CHECK_EQ(IIKitCfg.debounceMs, 50);
+    Serial.tx.clear();
+    configCommand(Serial, "debounceMs 20");
+    HOST_CHECK(Serial.tx.find("debounceMs=20 [0..5000] padrao 50") != std::string::npos);
+    HOST_CHECK_EQ(IIKitCfg.debounceMs, 20);
+    // 1 MHz com 16 bits passaria do relógio do LEDC: o valor anterior é mantido.
+    Serial.tx.clear();
+    configCommand(Serial, "pwmFreq 1000000");
+    HOST_CHECK(Serial.tx.find("cfg: combinacao invalida pwmFreq=5000") != std::string::npos);
+    Serial.tx.clear();
+    configCommand(Serial, "nada 1");
+    HOST_CHECK(Serial.tx.find("cfg: parametro desconhecido nada") != std::string::npos);
+}
+
+void testSaveLoad() {
+    hostNvs.clear();
+    configDefaults();
+    HOST_CHECK(!configLoad()); // Sem blob: padrões.
+    IIKitCfg.pwmBits = 10;
+    IIKitCfg.out4a20Cal4 = 0.19f;
+    HOST_CHECK(configSave());
+    configDefaults();
+    HOST_CHECK(configLoad());
+    HOST_CHECK_EQ(IIKitCfg.pwmBits, 10);
+    HOST_CHECK_NEAR(IIKitCfg.out4a20Cal4, 0.19, 1e-6);
+}
+
+void testCorruptBlob() {
+    IIKitCfg.pwmBits = 10;
+    HOST_CHECK(configSave());
+    // Um bit trocado na configuração: o CRC não confere e tudo volta ao padrão.
+    std::vector<uint8_t> &blob = hostNvs["cfg"];
+    blob[offsetof(IIKitConfigBlob_t, cfg) + offsetof(IIKitConfig_t, pwmBits)] ^= 0x01;
+    HOST_CHECK(!configLoad());
+    HOST_CHECK_EQ(IIKitCfg.pwmBits, 12);
+    // Outra versão do esquema.
+    IIKitCfg.pwmBits = 10;
+    HOST_CHECK(configSave());
+    hostNvs["cfg"][offsetof(IIKitConfigBlob_t, version)]++;
+    HOST_CHECK(!configLoad());
+    HOST_CHECK_EQ(IIKitCfg.pwmBits, 12);
+    // Blob truncado.
+    HOST_CHECK(configSave());
+    hostNvs["cfg"].pop_back();
+    HOST_CHECK(!configLoad());
+}
+
+void testRangeOnLoad() {
+    // Um campo fora da faixa com CRC correto (esquema antigo com outra faixa, por exemplo)
+    // volta ao padrão sem descartar os demais.
+    configDefaults();
+    IIKitCfg.debounceMs = 9999;
+    IIKitCfg.pwmBits = 10;
+    HOST_CHECK(configSave());
+    HOST_CHECK(configLoad());
+    HOST_CHECK_EQ(IIKitCfg.debounceMs, 50);
+    HOST_CHECK_EQ(IIKitCfg.pwmBits, 10);
+    // Combinação que o LEDC não gera: a configuração inteira é descartada.
+    IIKitCfg.pwmFreq = 1000000;
+    IIKitCfg.pwmBits = 16;
+    HOST_CHECK(configSave());
+    HOST_CHECK(!configLoad());
+    HOST_CHECK_EQ(IIKitCfg.pwmFreq, 5000);
+    HOST_CHECK_EQ(IIKitCfg.pwmBits, 12);
+}
+
+int main() {
+    HOST_RUN(testParse);
+    HOST_RUN(testCommand);
+    HOST_RUN(testSaveLoad);
+    HOST_RUN(testCorruptBlob);
+    HOST_RUN(testRangeOnLoad);
+    return hostTestResult();
+}
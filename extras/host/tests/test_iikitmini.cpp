@@ -0,0 +1,46 @@
+/**
+ * @file test_iikitmini.cpp
+ * @brief Inicialização do kit: boot em segundo plano, ADS1115 ausente e loop de eventos ocioso.
+ *
+ * Compilado com IIKIT_EVENT_LOOP (CMakeLists.txt). A tarefa de boot roda quando o teste
+ * chama hostTaskRun().
+ */
+
+#include "iikitmini.h"
+#include "hostTest.h"
+
+void testSetupWithoutAds() {
+    hostAdsPresent = false; // O chip não responde no I2C.
+    IIKit.setup();
+    // Boot em segundo plano (padrão): o setup() retorna antes de display e ADS1115.
+    HOST_CHECK(!IIKit.ready());
+    HOST_CHECK_EQ(oled().frames, 0);
+    HOST_CHECK(!IIKit.waitReady(5));
+    HOST_CHECK(hostTaskRun("iikitBoot"));
+    HOST_CHECK(IIKit.ready());
+    HOST_CHECK(IIKit.waitReady(0));
+    // Texto inicial e "Mode: sem WIFI" saem em um único quadro pelo I2C.
+    HOST_CHECK_EQ(oled().frames, 1);
+    HOST_CHECK(Serial.tx.find("WARN: ADS1115 nao encontrado") != std::string::npos);
+    HOST_CHECK_EQ(IIKit.analogReadPot1(), 0);
+    // Sem varredura não há prazo vencido: o loop dorme até o display, em vez de girar. A
+    // janela de 1 s não está alinhada ao período do display e começa com o sinal do boot.
+    HOST_CHECK(jeventNextDue(UINT32_MAX) > 0);
+    const uint32_t wake0 = jeventWakeups();
+    const uint64_t t0 = _hostMicros;
+    while (_hostMicros - t0 < 1000000ULL) IIKit.loop();
+    HOST_CHECK(jeventWakeups() - wake0 <= 1000000ULL / IIKIT_DISPLAY_PERIOD_US + 2);
+}
+
+void testSerialCommand() {
+    Serial.tx.clear();
+    Serial.inject("cfg pwmBits\n");
+    IIKit.loop();
+    HOST_CHECK(Serial.tx.find("pwmBits=12") != std::string::npos);
+}
+
+int main() {
+    HOST_RUN(testSetupWithoutAds);
+    HOST_RUN(testSerialCommand);
+    return hostTestResult();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file test_jalarm.cpp
+ * @brief Alarmes por bloco: retardos, banda morta, taxa de variação, relé e fila de eventos.
+ *
+ * Compilado com JALARM_EVENTS=4 (CMakeLists.txt) para encher a fila de transições.
+ */
+
+#include "util/iikitBoard.h"
+#include "util/jalarm.h"
+#include "hostTest.h"
+
+/** Placa com o relé em outro pino, para o parâmetro de template de jalarmEvaluate(). */
+struct RelayOn13Board : IIKitminiBoard {
+    static constexpr uint8_t pinRELE = 13;
+};
+
+int16_t buf[100];
+uint64_t t = 0;
+const uint32_t period = 100; // Blocos de 100 amostras = 10 ms.
+
+void reset() {
+    jalarmIndex = 0;
+    JAlarmEvent_t ev;
+    while (jalarmPop(&ev)) {}
+    _jalarmInterlocks = 0;
+    _jalarmLost = 0;
+    _hostPinLevel[def_pin_RELE] = 0;
+    _hostPinLevel[13] = 0;
+}
+
+template <class Board = IIKIT_BOARD>
+void block(uint8_t ch, int16_t a, int16_t b) {
+    for (int i = 0; i < 100; i++) buf[i] = a + (b - a) * i / 99;
+    jalarmEvaluate<Board>(ch, buf, 100, t, period);
+    t += 100 * period;
+}
+
+void testHiHiDelaysAndRelay() {
+    reset();
+    const int8_t hh = jalarmAdd(0, JALARM_HIHI, 3000, 100, 20, 50, true);
+    block(0, 2000, 2000);
+    block(0, 3100, 3100); // Acima do limite há 10 ms: delayOn de 20 ms ainda não venceu.
+    HOST_CHECK(!jalarmActive(hh));
+    block(0, 3100, 3100);
+    HOST_CHECK(jalarmActive(hh));
+    HOST_CHECK_EQ(_hostPinLevel[def_pin_RELE], JALARM_RELAY_ACTIVE);
+    // Dentro da banda morta (3000 - 100): continua ativo.
+    for (int i = 0; i < 10; i++) block(0, 2950, 2950);
+    HOST_CHECK(jalarmActive(hh));
+    // Abaixo da banda morta por mais que delayOff (50 ms).
+    for (int i = 0; i < 4; i++) block(0, 2850, 2850);
+    HOST_CHECK(jalarmActive(hh));
+    for (int i = 0; i < 2; i++) block(0, 2850, 2850);
+    HOST_CHECK(!jalarmActive(hh));
+    HOST_CHECK_EQ(_hostPinLevel[def_pin_RELE], !JALARM_RELAY_ACTIVE);
+    JAlarmEvent_t ev;
+    HOST_CHECK(jalarmPop(&ev));
+    HOST_CHECK(ev.active);
+    HOST_CHECK_EQ(ev.value, 3100);
+    HOST_CHECK(jalarmPop(&ev));
+    HOST_CHECK(!ev.active);
+    HOST_CHECK(!jalarmPop(&ev));
+}
+
+void testRelayFromBoard() {
+    reset();
+    jalarmAdd(0, JALARM_HI, 100, 0, 0, 0, true);
+    block<RelayOn13Board>(0, 200, 200);
+    HOST_CHECK_EQ(_hostPinLevel[13], JALARM_RELAY_ACTIVE);
+    HOST_CHECK_EQ(_hostPinLevel[def_pin_RELE], 0);
+}
+
+void testRateOfChange() {
+    reset();
+    // 0 -> 990 contagens em 99 amostras de 100 us: 100000 contagens/s.
+    const int8_t roc = jalarmAdd(0, JALARM_ROC, 50000);
+    block(0, 0, 990);
+    HOST_CHECK(jalarmActive(roc));
+    block(0, 990, 990);
+    HOST_CHECK(!jalarmActive(roc));
+}
+
+void testLostEvents() {
+    reset();
+    jalarmAdd(0, JALARM_HI, 100);
+    for (int i = 0; i < JALARM_EVENTS + 2; i++) block(0, (i & 1) ? 0 : 200, (i & 1) ? 0 : 200);
+    HOST_CHECK_EQ(jalarmLost(), 2);
+}
+
+int main() {
+    HOST_RUN(testHiHiDelaysAndRelay);
+    HOST_RUN(testRelayFromBoard);
+    HOST_RUN(testRateOfChange);
+    HOST_RUN(testLostEvents);
+    return hostTestResult();
+}
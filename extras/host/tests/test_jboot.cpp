@@ -0,0 +1,91 @@
+/**
+ * @file test_jboot.cpp
+ * @brief Medição da inicialização: etapas do setup(), etapas sobrepostas, limite de etapas,
+ * primeiro ciclo e comando "boot".
+ *
+ * Compilado com IIKIT_SYNC_BOOT e NUMBOOTSTAGES=8 (CMakeLists.txt).
+ */
+
+#include "iikitmini.h"
+#include "hostTest.h"
+
+/**
+ * @brief Índice da etapa com esse nome, ou -1.
+ */
+int stageIndex(const char *name) {
+    for (uint8_t i = 0; i < jbootIndex && i < NUMBOOTSTAGES; i++) {
+        if (strcmp(jbootStages[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+void testSetupStages() {
+    hostClockSet(100000);
+    IIKit.setup();
+    // IIKIT_SYNC_BOOT: display e ADS1115 dentro do setup(), com um único quadro no display.
+    HOST_CHECK(IIKit.ready());
+    HOST_CHECK_EQ(oled().frames, 1);
+    const char *order[] = {"outputs", "config", "serial", "io", "display", "ads"};
+    for (uint8_t i = 0; i < 6; i++) {
+        HOST_CHECK_EQ(stageIndex(order[i]), i);
+        HOST_CHECK(jbootStages[i].us != 0); // Todas fechadas.
+        HOST_CHECK(jbootStages[i].start >= 100000);
+    }
+    // Saídas seguras antes de qualquer outra etapa.
+    HOST_CHECK(jbootStages[0].start <= jbootStages[1].start);
+    HOST_CHECK_EQ(jbootFirstCycleUs(), 0);
+}
+
+void testFirstCycle() {
+    hostClockSet(250000);
+    IIKit.loop();
+    HOST_CHECK_EQ(jbootFirstCycleUs(), 250000);
+    hostClockAdvance(1000);
+    IIKit.loop();
+    HOST_CHECK_EQ(jbootFirstCycleUs(), 250000); // Só a primeira chamada conta.
+}
+
+void testOverlapAndLimit() {
+    // Etapas abertas ao mesmo tempo (setup() e tarefa de boot) são fechadas independentemente.
+    const uint32_t t0 = (uint32_t)_hostMicros;
+    const uint8_t a = jbootBegin("a");
+    hostClockAdvance(10);
+    const uint8_t b = jbootBegin("b");
+    hostClockAdvance(20);
+    jbootEnd(a);
+    HOST_CHECK_EQ(jbootStages[a].us, 30);
+    HOST_CHECK_EQ(jbootStages[b].us, 0); // Ainda aberta.
+    jbootEnd(b);
+    HOST_CHECK_EQ(jbootStages[b].us, 20);
+    HOST_CHECK_EQ(jbootStages[b].start, t0 + 10);
+    // Sem espaço: a etapa não é registrada e jbootEnd() a ignora.
+    const uint8_t full = jbootBegin("extra");
+    HOST_CHECK_EQ(full, NUMBOOTSTAGES);
+    jbootEnd(full);
+    // Etapa que dura menos de 1 us aparece como 1 (0 indica etapa aberta).
+    jbootIndex = 0;
+    jbootEnd(jbootBegin("fast"));
+    HOST_CHECK_EQ(jbootStages[0].us, 1);
+}
+
+void testCommand() {
+    jbootIndex = 0;
+    hostClockSet(300000);
+    const uint8_t st = jbootBegin("sensor");
+    hostClockAdvance(1500);
+    jbootEnd(st);
+    jbootBegin("open");
+    Serial.tx.clear();
+    jbootCommand(Serial, "");
+    HOST_CHECK(Serial.tx.find("boot first=250000") != std::string::npos);
+    HOST_CHECK(Serial.tx.find("sensor start=300000 us=1500") != std::string::npos);
+    HOST_CHECK(Serial.tx.find("open start=301500 us=\r\n") != std::string::npos);
+}
+
+int main() {
+    HOST_RUN(testSetupStages);
+    HOST_RUN(testFirstCycle);
+    HOST_RUN(testOverlapAndLimit);
+    HOST_RUN(testCommand);
+    return hostTestResult();
+}
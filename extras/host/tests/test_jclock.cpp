@@ -0,0 +1,69 @@
+/**
+ * @file test_jclock.cpp
+ * @brief Relógio de amostragem: blocos contíguos, deriva do cristal e detecção de lacunas.
+ */
+
+#include "util/jclock.h"
+#include "hostTest.h"
+#include <random>
+
+void testContiguousBlocks() {
+    jClock_t c;
+    jclockInit(&c, 100);
+    uint32_t seq;
+    // Leituras sem atraso: t0 do bloco seguinte = t0 + count * período.
+    uint64_t t0 = jclockStamp(&c, 50, 10000 + 49 * 100, &seq);
+    HOST_CHECK_EQ(t0, 10000);
+    HOST_CHECK_EQ(seq, 0);
+    for (uint32_t i = 1; i < 20; i++) {
+        const uint64_t t = jclockStamp(&c, 50, 10000 + (i * 50 + 49) * 100, &seq);
+        HOST_CHECK_EQ(t, t0 + 50 * 100);
+        HOST_CHECK_EQ(seq, i);
+        t0 = t;
+    }
+    HOST_CHECK_EQ(c.gaps, 0);
+}
+
+void testLateReadIsFiltered() {
+    jClock_t c;
+    jclockInit(&c, 100);
+    jclockStamp(&c, 50, 4900);
+    // Uma leitura 3 ms atrasada desloca a previsão só em 1/2^JCLOCK_SHIFT do atraso.
+    const uint64_t t0 = jclockStamp(&c, 50, 9900 + 3000);
+    HOST_CHECK_NEAR((double)t0, 5000.0, 3000.0 / (1 << JCLOCK_SHIFT) + 1);
+}
+
+void testDriftAndGap() {
+    // I2S a 1 kHz nominal com cristal 150 ppm lento; leituras a cada 20 amostras com
+    // atraso de 0 a 3 ms; na leitura 1500 se perdem 400 amostras.
+    jClock_t c;
+    jclockInit(&c, 1000, 256000);
+    std::mt19937 g(3);
+    std::uniform_int_distribution<int> lat(0, 3000);
+    const double truePeriod = 1000.15;
+    uint64_t k = 0;
+    uint32_t seq, lastSeq = 0;
+    int gaps = 0;
+    double maxErr = 0;
+    for (int i = 0; i < 2000; i++) {
+        if (i == 1500) k += 400;
+        const double tLast = 5000 + (k + 19) * truePeriod;
+        const uint64_t t0 = jclockStamp(&c, 20, (int64_t)(tLast + lat(g)), &seq);
+        if (i > 0 && seq != lastSeq + 1) gaps++;
+        lastSeq = seq;
+        const double err = fabs((double)t0 - (5000 + k * truePeriod));
+        if (i > 300 && !(i >= 1500 && i < 1800)) maxErr = err > maxErr ? err : maxErr;
+        k += 20;
+    }
+    HOST_CHECK_NEAR(jclockPeriodNs(&c), 1000150, 20);
+    HOST_CHECK(maxErr < 1000.0); // Bem abaixo do atraso máximo de leitura (3 ms).
+    HOST_CHECK_EQ(gaps, 1);
+    HOST_CHECK_EQ(c.gaps, 1);
+}
+
+int main() {
+    HOST_RUN(testContiguousBlocks);
+    HOST_RUN(testLateReadIsFiltered);
+    HOST_RUN(testDriftAndGap);
+    return hostTestResult();
+}
@@ -0,0 +1,126 @@
+/**
+ * @file test_jcontrol.cpp
+ * @brief PID em ponto fixo: degrau proporcional, rampa integral, anti-windup, troca de ganhos
+ * na execução seguinte e faixa dos ganhos.
+ *
+ * jcontrolStep() é chamada diretamente, sem o timer, com a variável de processo em pv.
+ */
+
+#include "util/jcontrol.h"
+#include "hostTest.h"
+
+int32_t pv = 0;
+int32_t lastOut = 0;
+
+int32_t readPv() { return pv; }
+void writeOut(int32_t q16) { lastOut = q16; }
+
+/**
+ * @brief Malha de 1 ms em automático, com a saída e o integrador em zero.
+ */
+uint8_t newLoop(float kp, float ki, float kd) {
+    const int8_t h = jcontrolAttach(readPv, writeOut, 1000);
+    HOST_CHECK(h >= 0);
+    HOST_CHECK(jcontrolTune(h, kp, ki, kd));
+    pv = 0;
+    jcontrolSetpoint(h, 0);
+    jcontrolAuto(h);
+    jcontrolStep(jcontrolStruct[h]); // Transferência bumpless a partir da saída manual 0.
+    HOST_CHECK_EQ(lastOut, 0);
+    return h;
+}
+
+void testProportionalStep() {
+    const uint8_t h = newLoop(0.0002f, 0.0f, 0.0f);
+    jcontrolSetpoint(h, 500);
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_NEAR(lastOut, 0.0002 * 500 * 65536, 2); // Kp * erro, em Q16.
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_NEAR(lastOut, 0.0002 * 500 * 65536, 2); // Sem integral a saída não muda.
+}
+
+void testIntegralRamp() {
+    const uint8_t h = newLoop(0.0f, 1.0f, 0.0f);
+    jcontrolSetpoint(h, 10);
+    // Ki * Ts * erro = 1 * 0.001 * 10 = 1% da saída por execução.
+    for (int i = 1; i <= 20; i++) {
+        jcontrolStep(jcontrolStruct[h]);
+        HOST_CHECK_NEAR(lastOut, i * 0.01 * 65536, 2);
+    }
+}
+
+void testAntiWindup() {
+    const uint8_t h = newLoop(0.0f, 10.0f, 0.0f);
+    jcontrolLimits(h, 0.0f, 0.5f);
+    jcontrolSetpoint(h, 1000);
+    for (int i = 0; i < 1000; i++) jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_EQ(lastOut, 32768);
+    // Com o erro invertido a saída sai do limite já na primeira execução.
+    pv = 2000;
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK(lastOut < 32768);
+}
+
+void testDerivativeOnMeasurement() {
+    const uint8_t h = newLoop(0.0f, 0.0f, 0.0001f);
+    // -Kd / Ts * dPV = -0.0001 / 0.001 * (-5) = 0.5: o sinal é oposto ao de dPV.
+    pv = -5;
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_NEAR(lastOut, 32768, 1);
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_EQ(lastOut, 0); // PV parada: termo derivativo nulo.
+}
+
+void testManualMode() {
+    const uint8_t h = newLoop(0.001f, 0.0f, 0.0f);
+    jcontrolManual(h, 0.25f);
+    jcontrolSetpoint(h, 1000);
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_EQ(lastOut, 16384);
+    // De volta ao automático sem solavanco: a saída parte de onde estava.
+    jcontrolAuto(h);
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_NEAR(lastOut, 16384, 1);
+}
+
+void testStagedGains() {
+    const uint8_t h = newLoop(0.001f, 0.0f, 0.0f);
+    const int64_t kp = jcontrolStruct[h].kp;
+    HOST_CHECK(jcontrolTune(h, 0.002f, 0.0f, 0.0f));
+    jcontrolLimits(h, 0.1f, 0.9f);
+    // Nada muda na malha até a próxima execução, que aplica ganhos e limites de uma vez.
+    HOST_CHECK_EQ(jcontrolStruct[h].kp, kp);
+    HOST_CHECK_EQ(jcontrolStruct[h].outMax, 1LL << 24);
+    HOST_CHECK(jcontrolStruct[h].pendingSet);
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK(!jcontrolStruct[h].pendingSet);
+    HOST_CHECK_EQ(jcontrolStruct[h].kp, 2 * kp);
+    HOST_CHECK_EQ(jcontrolStruct[h].outMin, (int64_t)(0.1f * 16777216.0f));
+    HOST_CHECK_EQ(jcontrolStruct[h].outMax, (int64_t)(0.9f * 16777216.0f));
+    HOST_CHECK_EQ(lastOut, (int32_t)((int64_t)(0.1f * 16777216.0f) >> 8)); // Já limitada pelo novo mínimo.
+}
+
+void testTuneRange() {
+    const uint8_t h = newLoop(0.001f, 0.0f, 0.0f);
+    const int64_t kp = jcontrolStruct[h].kp;
+    HOST_CHECK(!jcontrolTune(h, 1e9f, 0.0f, 0.0f)); // Kp em Q24 passaria de JCONTROL_GAIN_MAX.
+    HOST_CHECK(!jcontrolTune(h, 0.0f, 0.0f, 0.0f, -1.0f));
+    HOST_CHECK(!jcontrolTune(h, NAN, 0.0f, 0.0f));
+    HOST_CHECK_EQ(jcontrolStruct[h].kp, kp); // Ganhos anteriores mantidos.
+    HOST_CHECK(jcontrolTune(h, 0.0f, 0.0f, 1.0f)); // Kd / Ts = 1000 cabe em 64 bits.
+    jcontrolStep(jcontrolStruct[h]);
+    HOST_CHECK_EQ(jcontrolStruct[h].kd, 16777216000LL);
+    HOST_CHECK_EQ(_jcontrolMul(JCONTROL_GAIN_MAX, 1LL << 40), JCONTROL_SAT);
+    HOST_CHECK_EQ(_jcontrolMul(-JCONTROL_GAIN_MAX, 1LL << 40), -JCONTROL_SAT);
+}
+
+int main() {
+    HOST_RUN(testProportionalStep);
+    HOST_RUN(testIntegralRamp);
+    HOST_RUN(testAntiWindup);
+    HOST_RUN(testDerivativeOnMeasurement);
+    HOST_RUN(testManualMode);
+    HOST_RUN(testStagedGains);
+    HOST_RUN(testTuneRange);
+    return hostTestResult();
+}
@@ -0,0 +1,61 @@
+/**
+ * @file test_jevent.cpp
+ * @brief Loop de eventos: TIMEOUT só por prazo vencido, sinais, filas de drivers e handlers.
+ */
+
+#include "util/jevent.h"
+#include "hostTest.h"
+
+uint64_t dueAt = UINT64_MAX; ///< Prazo (relógio virtual) do subsistema simulado.
+uint32_t handled = 0;
+
+void testBegin() {
+    HOST_CHECK(jeventBegin());
+    jeventAddDeadline([]() -> uint32_t {
+        if (dueAt == UINT64_MAX) return UINT32_MAX;
+        return dueAt > _hostMicros ? (uint32_t)(dueAt - _hostMicros) : 0;
+    });
+    jeventAttach(JEVENT_ANY, [](uint32_t bits) { handled |= bits; });
+}
+
+void testTimeoutOnlyWhenDue() {
+    dueAt = _hostMicros + 5000;
+    handled = 0;
+    // O fim de maxWait não é prazo de ninguém: jeventWait(0) não sinaliza TIMEOUT.
+    HOST_CHECK_EQ(jeventWait(0), 0);
+    HOST_CHECK_EQ(handled, 0);
+    // A espera vai até o prazo (5 ms no relógio virtual) e então sinaliza TIMEOUT.
+    const uint64_t t0 = _hostMicros;
+    HOST_CHECK_EQ(jeventWait(), JEVENT_TIMEOUT);
+    HOST_CHECK_EQ(_hostMicros - t0, 5000);
+    HOST_CHECK_EQ(jeventWait(0), JEVENT_TIMEOUT); // Continua vencido até o subsistema agir.
+    dueAt = UINT64_MAX;
+}
+
+void testSignal() {
+    handled = 0;
+    jeventSignal(JEVENT_USER);
+    jeventSignalFromISR(JEVENT_GPIO);
+    HOST_CHECK_EQ(jeventWait(0), JEVENT_USER | JEVENT_GPIO);
+    HOST_CHECK_EQ(handled, JEVENT_USER | JEVENT_GPIO);
+    HOST_CHECK_EQ(jeventWait(0), 0); // Os bits são consumidos.
+}
+
+void testQueueItemSize() {
+    QueueHandle_t big = xQueueCreate(2, JEVENT_ITEM_MAX + 1);
+    HOST_CHECK(!jeventAddQueue(big, JEVENT_ADC, JEVENT_ITEM_MAX + 1));
+    QueueHandle_t small = xQueueCreate(2, 8);
+    HOST_CHECK(jeventAddQueue(small, JEVENT_ADC, 8));
+    const uint8_t item[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    xQueueSend(small, item, 0);
+    HOST_CHECK_EQ(jeventWait(0), JEVENT_ADC);
+    HOST_CHECK_EQ(jeventWait(0), 0); // O item foi retirado da fila.
+}
+
+int main() {
+    HOST_RUN(testBegin);
+    HOST_RUN(testTimeoutOnlyWhenDue);
+    HOST_RUN(testSignal);
+    HOST_RUN(testQueueItemSize);
+    return hostTestResult();
+}
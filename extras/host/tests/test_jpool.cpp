@@ -0,0 +1,60 @@
+/**
+ * @file test_jpool.cpp
+ * @brief Pool de blocos: alocação até esgotar, contagem de referências e falhas.
+ *
+ * Compilado com JPOOL_BLOCKS=4 (CMakeLists.txt) para esgotar o pool com poucos blocos.
+ */
+
+#include "util/jpool.h"
+#include "hostTest.h"
+
+void testAllocUntilEmpty() {
+    HOST_CHECK_EQ(jpoolAvailable(), JPOOL_BLOCKS);
+    jBlock_t *b[JPOOL_BLOCKS];
+    for (uint8_t i = 0; i < JPOOL_BLOCKS; i++) {
+        b[i] = jpoolAlloc();
+        HOST_CHECK(b[i] != NULL);
+        HOST_CHECK_EQ(b[i]->refs, 1);
+        HOST_CHECK_EQ(b[i]->count, 0);
+    }
+    HOST_CHECK_EQ(jpoolAvailable(), 0);
+    HOST_CHECK(jpoolAlloc() == NULL);
+    HOST_CHECK_EQ(jpoolMisses(), 1);
+    for (uint8_t i = 0; i < JPOOL_BLOCKS; i++) jpoolRelease(b[i]);
+    HOST_CHECK_EQ(jpoolAvailable(), JPOOL_BLOCKS);
+}
+
+void testRefcount() {
+    jBlock_t *b = jpoolAlloc();
+    jpoolRetain(b);
+    jpoolRetain(b);
+    HOST_CHECK_EQ(b->refs, 3);
+    jpoolRelease(b);
+    jpoolRelease(b);
+    HOST_CHECK_EQ(jpoolAvailable(), JPOOL_BLOCKS - 1); // Ainda há um consumidor.
+    jpoolRelease(b);
+    HOST_CHECK_EQ(jpoolAvailable(), JPOOL_BLOCKS);
+    jpoolRelease(b); // Liberação extra não pode devolver o bloco duas vezes.
+    HOST_CHECK_EQ(b->refs, 0);
+    HOST_CHECK_EQ(jpoolAvailable(), JPOOL_BLOCKS);
+    jpoolRelease(NULL);
+}
+
+void testReuseFreedBlock() {
+    jBlock_t *a = jpoolAlloc();
+    a->count = 10;
+    a->seq = 7;
+    jpoolRelease(a);
+    jBlock_t *b = jpoolAlloc();
+    HOST_CHECK(a == b); // O menor bloco livre é reaproveitado, com os metadados zerados.
+    HOST_CHECK_EQ(b->count, 0);
+    HOST_CHECK_EQ(b->seq, 0);
+    jpoolRelease(b);
+}
+
+int main() {
+    HOST_RUN(testAllocUntilEmpty);
+    HOST_RUN(testRefcount);
+    HOST_RUN(testReuseFreedBlock);
+    return hostTestResult();
+}
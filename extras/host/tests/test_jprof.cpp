@@ -0,0 +1,96 @@
+/**
+ * @file test_jprof.cpp
+ * @brief Probes de tempo: faixas do histograma, percentil 99, medição por escopo, período
+ * e estouros do loop, reset e comando "prof".
+ *
+ * Compilado com IIKIT_PROFILE e NUMPROBES=4 (CMakeLists.txt). No host o CCOUNT segue o
+ * relógio virtual a 240 ciclos por us (xtensa/hal.h).
+ */
+
+#include "util/jprof.h"
+#include "hostTest.h"
+
+void testBuckets() {
+    // Cada duração cai na faixa cujo limite superior está acima dela e o da anterior não.
+    for (uint32_t c = 2; c < 100000; c++) {
+        const uint8_t b = jprofBucket(c);
+        HOST_CHECK(c < jprofBucketTop(b));
+        HOST_CHECK(c >= jprofBucketTop(b - 1));
+    }
+    HOST_CHECK_EQ(jprofBucket(4), 4);
+    HOST_CHECK_EQ(jprofBucketTop(4), 6); // [4, 6) e [6, 8): 2 faixas por oitava.
+    HOST_CHECK_EQ(jprofBucket(6), 5);
+    HOST_CHECK_EQ(jprofBucket(UINT32_MAX), JPROF_BUCKETS - 1);
+    HOST_CHECK_EQ(jprofBucketTop(JPROF_BUCKETS - 1), UINT32_MAX);
+}
+
+void testP99() {
+    const uint8_t id = jprofRegister("p99");
+    for (int i = 0; i < 99; i++) jprofRecord(id, 240);
+    jprofRecord(id, 24000);
+    const JProbe_t &p = jprofStruct[id];
+    HOST_CHECK_EQ(p.count, 100);
+    HOST_CHECK_EQ(p.min, 240);
+    HOST_CHECK_EQ(p.max, 24000);
+    HOST_CHECK_EQ(jprofP99(p), 256); // Topo da faixa de 240: um outlier em 100 não conta.
+    jprofRecord(id, 24000);
+    HOST_CHECK_EQ(jprofP99(p), 24000); // Dois em 101: limitado ao máximo observado.
+}
+
+void testScopeAndLoop() {
+    hostClockSet(1000);
+    for (int i = 0; i < 3; i++) {
+        JPROF_SCOPE("filtro");
+        hostClockAdvance(10 + i);
+    }
+    const uint8_t id = jprofIndex - 1;
+    HOST_CHECK_EQ(jprofStruct[id].count, 3);
+    HOST_CHECK_EQ(jprofStruct[id].min, 10 * 240);
+    HOST_CHECK_EQ(jprofStruct[id].max, 12 * 240);
+    HOST_CHECK_EQ(jprofStruct[id].sum, 33 * 240);
+    // Iterações de 500, 1500 e 800 us com orçamento de 1000 us.
+    const uint32_t periods[] = {500, 1500, 800};
+    JPROF_LOOP(1000);
+    for (int i = 0; i < 3; i++) {
+        hostClockAdvance(periods[i]);
+        JPROF_LOOP(1000);
+    }
+    HOST_CHECK_EQ(_jprofLoopCount, 3);
+    HOST_CHECK_EQ(_jprofLoopOverruns, 1);
+    HOST_CHECK_EQ(_jprofLoopMax, 1500 * 240);
+}
+
+void testCommandAndReset() {
+    Serial.tx.clear();
+    jprofCommand(Serial, "");
+    HOST_CHECK(Serial.tx.find("filtro n=3 min=10.00 avg=11.00 p99=12.00 max=12.00") != std::string::npos);
+    HOST_CHECK(Serial.tx.find("loop hz=1071.43 max=1500.00 overruns=1") != std::string::npos);
+    Serial.tx.clear();
+    jprofCommand(Serial, " reset");
+    HOST_CHECK(Serial.tx.find("prof: reset") != std::string::npos);
+    HOST_CHECK_EQ(_jprofLoopCount, 0);
+    for (uint8_t i = 0; i < jprofIndex; i++) {
+        HOST_CHECK_EQ(jprofStruct[i].count, 0);
+        HOST_CHECK_EQ(jprofStruct[i].min, UINT32_MAX);
+    }
+    HOST_CHECK(strcmp(jprofStruct[jprofIndex - 1].name, "filtro") == 0);
+    // Probes sem medições e loop sem iterações não aparecem.
+    Serial.tx.clear();
+    jprofCommand(Serial, "");
+    HOST_CHECK(Serial.tx.empty());
+}
+
+void testProbeLimit() {
+    while (jprofIndex < NUMPROBES) jprofRegister("x");
+    HOST_CHECK_EQ(jprofRegister("extra"), NUMPROBES);
+    jprofRecord(NUMPROBES, 100); // Probe sem espaço: ignorado.
+}
+
+int main() {
+    HOST_RUN(testBuckets);
+    HOST_RUN(testP99);
+    HOST_RUN(testScopeAndLoop);
+    HOST_RUN(testCommandAndReset);
+    HOST_RUN(testProbeLimit);
+    return hostTestResult();
+}
@@ -0,0 +1,61 @@
+/**
+ * @file test_jqueue.cpp
+ * @brief Fila de ponteiros: ordem FIFO, fila cheia/vazia e volta do buffer circular.
+ */
+
+#include "util/jqueue.h"
+#include "hostTest.h"
+
+int items[2 * MAXLENGTHJQUEUE];
+
+void testEmpty() {
+    jQueue_t q;
+    jQueueInit(&q);
+    void *item = NULL;
+    HOST_CHECK(jQueueIsEmpty(&q));
+    HOST_CHECK(!jQueueIsFull(&q));
+    HOST_CHECK(!jQueueReceive(&q, &item));
+    HOST_CHECK(item == NULL);
+}
+
+void testFullAndOrder() {
+    jQueue_t q;
+    jQueueInit(&q);
+    for (int i = 0; i < MAXLENGTHJQUEUE; i++) HOST_CHECK(jQueueSendFromISR(&q, &items[i]));
+    HOST_CHECK(jQueueIsFull(&q));
+    HOST_CHECK(!jQueueSendFromISR(&q, &items[MAXLENGTHJQUEUE]));
+    HOST_CHECK_EQ(jQueueSize(&q), MAXLENGTHJQUEUE);
+    void *item;
+    for (int i = 0; i < MAXLENGTHJQUEUE; i++) {
+        HOST_CHECK(jQueueReceive(&q, &item));
+        HOST_CHECK(item == &items[i]);
+    }
+    HOST_CHECK(jQueueIsEmpty(&q));
+}
+
+void testWrapAround() {
+    jQueue_t q;
+    jQueueInit(&q);
+    void *item;
+    // Intercala envios e recepções para que head e tail deem várias voltas no buffer.
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 4 * MAXLENGTHJQUEUE; round++) {
+        HOST_CHECK(jQueueSendFromISR(&q, &items[next++ % (2 * MAXLENGTHJQUEUE)]));
+        if (round % 2 == 1) {
+            HOST_CHECK(jQueueReceive(&q, &item));
+            HOST_CHECK(item == &items[expected++ % (2 * MAXLENGTHJQUEUE)]);
+        }
+        if (jQueueIsFull(&q)) {
+            while (jQueueReceive(&q, &item)) HOST_CHECK(item == &items[expected++ % (2 * MAXLENGTHJQUEUE)]);
+        }
+    }
+    HOST_CHECK_EQ(jQueueSize(&q), next - expected);
+}
+
+int main() {
+    HOST_RUN(testEmpty);
+    HOST_RUN(testFullAndOrder);
+    HOST_RUN(testWrapAround);
+    return hostTestResult();
+}
@@ -0,0 +1,112 @@
+/**
+ * @file test_jsleep.cpp
+ * @brief Light sleep: duração do sono até o próximo prazo, condições que impedem o sono
+ * (prazo curto, rajada, LEDC ativo), clocks de rajada, despertar por pino e UART e comando
+ * "sleep".
+ *
+ * O light sleep do shim (esp_sleep.h) avança o relógio virtual até o timer ou até o
+ * despertar externo agendado com hostSleepWakeAt().
+ */
+
+#include "util/jsleep.h"
+#include "hostTest.h"
+
+uint32_t gpioEvents = 0;
+
+void testDelayClamp() {
+    hostClockSet(1000000);
+    HOST_CHECK(jeventBegin());
+    // 5000 s em ms não cabe em us de 32 bits: satura em vez de dar a volta.
+    static AsyncDelay_c slow(5000000UL);
+    HOST_CHECK(jsleepAddDelay(&slow));
+    HOST_CHECK_EQ(jsleepNextDue(UINT32_MAX), UINT32_MAX);
+}
+
+void testSleepUntilDelay() {
+    static AsyncDelay_c logTimer(1000);
+    HOST_CHECK(jsleepAddDelay(&logTimer));
+    jsleepReset();
+    const uint64_t t0 = _hostMicros;
+    jsleepLoop();
+    // Acorda JSLEEP_GUARD_US antes do vencimento.
+    HOST_CHECK_EQ(_jsleepCount, 1);
+    HOST_CHECK_EQ(_jsleepWakeTimer, 1);
+    HOST_CHECK_EQ(_hostMicros, t0 + 1000000ULL - JSLEEP_GUARD_US);
+    // Falta menos que JSLEEP_MIN_US: só espera no jevent.
+    jsleepLoop();
+    HOST_CHECK_EQ(_jsleepCount, 1);
+    HOST_CHECK(logTimer.isExpired());
+}
+
+void testNoSleepWhenBusy() {
+    jsleepReset();
+    // Rajada em andamento, com clocks de repouso e de rajada.
+    jsleepClocks(80, 240);
+    HOST_CHECK_EQ(getCpuFrequencyMhz(), 80);
+    jsleepBurstBegin();
+    jsleepBurstBegin();
+    HOST_CHECK_EQ(getCpuFrequencyMhz(), 240);
+    jsleepLoop(100000);
+    HOST_CHECK_EQ(_jsleepCount, 0);
+    jsleepBurstEnd();
+    HOST_CHECK_EQ(getCpuFrequencyMhz(), 240); // Ainda há uma rajada aberta.
+    jsleepBurstEnd();
+    jsleepBurstEnd(); // Fim sem início: ignorado.
+    HOST_CHECK_EQ(getCpuFrequencyMhz(), 80);
+    HOST_CHECK_EQ(_jsleepBurst, 0);
+    // Saída do LEDC com duty: o clock do APB precisa continuar.
+    LedcOut_c out;
+    HOST_CHECK(out.begin(25, LEDC_CHANNEL_0, LEDC_TIMER_0, 5000, 12));
+    out.write(100);
+    jsleepLoop(100000);
+    HOST_CHECK_EQ(_jsleepCount, 0);
+    out.write(0);
+    jsleepLoop(100000);
+    HOST_CHECK_EQ(_jsleepCount, 1);
+    // Clock abaixo de 80 MHz não é aceito (mudaria o APB).
+    jsleepClocks(40, 0);
+    HOST_CHECK_EQ(getCpuFrequencyMhz(), 80);
+}
+
+void testWakeSources() {
+    jeventAttach(JEVENT_GPIO, [](uint32_t) { gpioEvents++; });
+    HOST_CHECK(jsleepWakePin(4, RISING));
+    jsleepWakeUart(0);
+    jsleepReset();
+    // Borda no pino 200 ms depois: acorda antes do timer e sinaliza JEVENT_GPIO.
+    hostSleepWakeAt(_hostMicros + 200000, ESP_SLEEP_WAKEUP_GPIO);
+    const uint64_t t0 = _hostMicros;
+    HOST_CHECK(jsleepLoop(500000) & JEVENT_GPIO);
+    HOST_CHECK_EQ(_hostMicros, t0 + 200000);
+    HOST_CHECK_EQ(_jsleepWakeGpio, 1);
+    HOST_CHECK_EQ(gpioEvents, 1);
+    hostSleepWakeAt(_hostMicros + 50000, ESP_SLEEP_WAKEUP_UART);
+    HOST_CHECK(jsleepLoop(500000) & JEVENT_UART);
+    HOST_CHECK_EQ(_jsleepWakeUart, 1);
+    HOST_CHECK_EQ(_jsleepCount, 2);
+    HOST_CHECK_EQ(_jsleepAsleepUs, 250000);
+}
+
+void testCommand() {
+    jsleepReset();
+    jsleepLoop(100000);
+    hostClockAdvance(1000);
+    Serial.tx.clear();
+    jsleepCommand(Serial, "");
+    // 99 ms dormindo em 100 ms: 1% acordado.
+    HOST_CHECK(Serial.tx.find("sleep duty=1.00 n=1 avg=99000 timer=1 gpio=0 uart=0") != std::string::npos);
+    Serial.tx.clear();
+    jsleepCommand(Serial, "reset");
+    HOST_CHECK(Serial.tx.find("sleep: reset") != std::string::npos);
+    HOST_CHECK_EQ(_jsleepCount, 0);
+    HOST_CHECK_NEAR(jsleepDutyCycle(), 1.0, 1e-6);
+}
+
+int main() {
+    HOST_RUN(testDelayClamp);
+    HOST_RUN(testSleepUntilDelay);
+    HOST_RUN(testNoSleepWhenBusy);
+    HOST_RUN(testWakeSources);
+    HOST_RUN(testCommand);
+    return hostTestResult();
+}
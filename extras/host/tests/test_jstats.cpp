@@ -0,0 +1,84 @@
+/**
+ * @file test_jstats.cpp
+ * @brief Estatísticas por janela: momentos exatos, percentis do histograma e fechamento.
+ */
+
+#include "util/jstats.h"
+#include "hostTest.h"
+#include <random>
+
+JStatsSummary_t last;
+int summaries = 0;
+
+void collect(uint8_t, const JStatsSummary_t &s) {
+    last = s;
+    summaries++;
+}
+
+void testUniformWindow() {
+    jstatsIndex = 0;
+    summaries = 0;
+    jstatsAdd(0, 100, collect);
+    int16_t buf[100];
+    for (int i = 0; i < 100; i++) buf[i] = i;
+    // 100 amostras a 1 ms: o bloco fecha a janela de 100 ms.
+    jstatsUpdate(0, buf, 100, 1000000, 1000);
+    HOST_CHECK_EQ(summaries, 1);
+    HOST_CHECK_EQ(last.count, 100);
+    HOST_CHECK_EQ(last.min, 0);
+    HOST_CHECK_EQ(last.max, 99);
+    HOST_CHECK_NEAR(last.mean, 49.5, 1e-4);
+    HOST_CHECK_NEAR(last.std, 29.0115, 1e-3);
+    HOST_CHECK_NEAR(last.rms, 57.3018, 1e-3);
+    // Toda a janela cabe na primeira faixa (0..127): interpolação limitada a min..max.
+    HOST_CHECK_EQ(last.p50, 50);
+    HOST_CHECK_EQ(last.p90, 90);
+    HOST_CHECK_EQ(last.p99, 99);
+}
+
+void testNormalWindow() {
+    jstatsIndex = 0;
+    summaries = 0;
+    jstatsAdd(0, 1000, collect);
+    std::mt19937 g(1);
+    std::normal_distribution<double> d(2000, 100);
+    int16_t buf[256];
+    double sum = 0, sq = 0;
+    uint64_t t = 1000000;
+    while (summaries == 0) {
+        for (int i = 0; i < 256; i++) {
+            buf[i] = (int16_t)lround(d(g));
+            sum += buf[i];
+            sq += buf[i] * (double)buf[i];
+        }
+        jstatsUpdate(0, buf, 256, t, 100);
+        t += 25600;
+    }
+    const double n = last.count;
+    const double mean = sum / n;
+    HOST_CHECK_NEAR(last.mean, mean, 1e-2);
+    HOST_CHECK_NEAR(last.std, sqrt((sq - n * mean * mean) / (n - 1)), 1e-2);
+    // Faixas de 128 contagens: percentis a menos de uma faixa dos da normal.
+    HOST_CHECK_NEAR(last.p50, 2000, 20);
+    HOST_CHECK_NEAR(last.p90, 2128, 40);
+    HOST_CHECK_NEAR(last.p99, 2233, 60);
+}
+
+void testChannelFilter() {
+    jstatsIndex = 0;
+    summaries = 0;
+    jstatsAdd(1, 10, collect);
+    int16_t buf[20] = {0};
+    jstatsUpdate(0, buf, 20, 0, 1000); // Outro canal: ignorado.
+    HOST_CHECK_EQ(summaries, 0);
+    jstatsUpdate(1, buf, 20, 0, 1000);
+    HOST_CHECK_EQ(summaries, 1);
+    HOST_CHECK_EQ(last.count, 20);
+}
+
+int main() {
+    HOST_RUN(testUniformWindow);
+    HOST_RUN(testNormalWindow);
+    HOST_RUN(testChannelFilter);
+    return hostTestResult();
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_ledcOut.cpp
+ * @brief Saída PWM do LEDC: limites de frequência x resolução, duty com 4 bits fracionários
+ * (dithering), escrita em Q16 e canais ativos para o light sleep.
+ *
+ * As escritas são conferidas nos registradores em RAM do shim (soc/ledc_struct.h).
+ */
+
+#include "util/ledcOut.h"
+#include "hostTest.h"
+
+/**
+ * @brief Duty gravado no registrador do canal (1/16 de LSB).
+ */
+uint32_t regDuty(ledc_channel_t ch) {
+    return LEDC.channel_group[LEDC_HIGH_SPEED_MODE].channel[ch].duty.duty;
+}
+
+void testValid() {
+    HOST_CHECK(ledcOutValid(1000, 16));       // 65.5 MHz.
+    HOST_CHECK(ledcOutValid(1220, 16));       // 79.95 MHz.
+    HOST_CHECK(!ledcOutValid(1221, 16));      // Passa dos 80 MHz do APB.
+    HOST_CHECK(ledcOutValid(5000, 12));
+    HOST_CHECK(!ledcOutValid(1000000, 7));    // 128 MHz.
+    HOST_CHECK(ledcOutValid(1000000, 6));
+    HOST_CHECK(ledcOutValid(489, 1));         // 978 Hz: o menor tick.
+    HOST_CHECK(!ledcOutValid(488, 1));
+    HOST_CHECK(!ledcOutValid(0, 8));
+    HOST_CHECK(!ledcOutValid(1000, 0));
+    HOST_CHECK(!ledcOutValid(1000, 17));
+}
+
+void testBeginRejected() {
+    LedcOut_c out;
+    HOST_CHECK(!out.begin(25, LEDC_CHANNEL_2, LEDC_TIMER_2, 1000000, 16));
+    HOST_CHECK(!out.ready());
+    // Canal não configurado: a escrita não toca o registrador, que pode ser de outro código.
+    LEDC.channel_group[LEDC_HIGH_SPEED_MODE].channel[LEDC_CHANNEL_2].duty.duty = 123;
+    out.write(10);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_2), 123);
+    HOST_CHECK(!LedcOut_c::anyActive());
+}
+
+void testDither() {
+    LedcOut_c out;
+    HOST_CHECK(out.begin(25, LEDC_CHANNEL_0, LEDC_TIMER_0, 5000, 12));
+    HOST_CHECK_EQ(out.maxDuty(), 4095);
+    out.write(100);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0), 1600);
+    // 1/3 do período: 4095 * 16 / 3 = 21840, com os 4 bits fracionários.
+    out.writeFraction(1.0f / 3);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0), 21840);
+    out.writeRaw(1607);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0), 1607);
+    // Sem dithering só o LSB inteiro vai ao registrador.
+    out.setDither(false);
+    out.writeRaw(1607);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0), 1600);
+    out.writeFraction(0.5f);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0) & 0x0F, 0);
+    out.setDither(true);
+    // Fora da faixa: satura.
+    out.writeFraction(1.5f);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0), 4095 * 16);
+    out.writeFraction(-1.0f);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_0), 0);
+}
+
+void testQ16() {
+    LedcOut_c out;
+    HOST_CHECK(out.begin(26, LEDC_CHANNEL_1, LEDC_TIMER_1, 1000, 16));
+    out.writeQ16(65536);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_1), 65535 * 16);
+    out.writeQ16(32768);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_1), 65535 * 8);
+    out.writeQ16(-5);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_1), 0);
+    out.writeQ16(70000);
+    HOST_CHECK_EQ(regDuty(LEDC_CHANNEL_1), 65535 * 16);
+}
+
+void testActive() {
+    LedcOut_c a, b;
+    HOST_CHECK(a.begin(25, LEDC_CHANNEL_0, LEDC_TIMER_0, 5000, 12));
+    HOST_CHECK(b.begin(26, LEDC_CHANNEL_1, LEDC_TIMER_1, 1000, 16));
+    a.write(0);
+    b.write(0);
+    HOST_CHECK(!LedcOut_c::anyActive());
+    a.write(1);
+    HOST_CHECK(LedcOut_c::anyActive());
+    b.fade(1000, 50); // Ativo durante a rampa.
+    a.write(0);
+    HOST_CHECK(LedcOut_c::anyActive());
+    b.write(0);
+    HOST_CHECK(!LedcOut_c::anyActive());
+    // Só a fração abaixo de 1/16 de LSB: zero no registrador, canal inativo.
+    a.writeFraction(0.000001f);
+    HOST_CHECK(!LedcOut_c::anyActive());
+}
+
+int main() {
+    HOST_RUN(testValid);
+    HOST_RUN(testBeginRejected);
+    HOST_RUN(testDither);
+    HOST_RUN(testQ16);
+    HOST_RUN(testActive);
+    return hostTestResult();
+}
@@ -0,0 +1,98 @@
+/**
+ * @file test_sampleSource.cpp
+ * @brief Fonte de sinais sintéticos: cada componente, saturação, reprodutibilidade do ruído
+ * e fase da senoide após dias de simulação.
+ */
+
+#include "util/sampleSource.h"
+#include "hostTest.h"
+
+void testDcAndRange() {
+    SignalSource_c sig;
+    HOST_CHECK_EQ(sig.sample(0), 0); // Tudo desligado.
+    sig.dc(1000);
+    HOST_CHECK_EQ(sig.sample(123456), 1000);
+    sig.dc(5000);
+    HOST_CHECK_EQ(sig.sample(0), 4095); // Faixa padrão do ADC de 12 bits.
+    sig.dc(-10);
+    HOST_CHECK_EQ(sig.sample(0), 0);
+    sig.range(-100, 100);
+    HOST_CHECK_EQ(sig.sample(0), -10);
+}
+
+void testSine() {
+    SignalSource_c sig;
+    sig.dc(2048).sine(1000, 50); // 50 Hz: período de 20 ms.
+    HOST_CHECK_EQ(sig.sample(0), 2048);
+    HOST_CHECK_EQ(sig.sample(5000), 3048);
+    HOST_CHECK_EQ(sig.sample(15000), 1048);
+    HOST_CHECK_EQ(sig.sample(20000), 2048);
+    sig.sine(1000, 50, (float)M_PI / 2); // Cosseno.
+    HOST_CHECK_EQ(sig.sample(0), 3048);
+    // Três dias depois a fase continua exata: 50 Hz tem um número inteiro de ciclos por segundo.
+    const uint64_t days = 3ULL * 86400ULL * 1000000ULL;
+    sig.sine(1000, 50);
+    HOST_CHECK_NEAR(sig.sample(days + 5000), 3048, 1);
+    // Frequência que não cabe em us inteiros (7 Hz): sem salto entre segundos.
+    sig.sine(1000, 7);
+    const int16_t before = sig.sample(days - 1000);
+    const int16_t after = sig.sample(days + 1000);
+    HOST_CHECK_NEAR(after - before, 2.0 * 1000 * 2 * M_PI * 7 * 1000e-6, 2);
+}
+
+void testStep() {
+    SignalSource_c sig;
+    sig.dc(100).step(500, 10000);
+    HOST_CHECK_EQ(sig.sample(9999), 100);
+    HOST_CHECK_EQ(sig.sample(10000), 600);
+    HOST_CHECK_EQ(sig.sample(1ULL << 40), 600);
+}
+
+void testNoise() {
+    SignalSource_c a, b, c;
+    a.dc(2048).noise(50, 7);
+    b.dc(2048).noise(50, 7);
+    c.dc(2048).noise(50, 8);
+    int16_t lo = 4095, hi = 0;
+    int same = 0;
+    double sum = 0;
+    for (uint64_t t = 0; t < 10000; t++) {
+        const int16_t v = a.sample(t * 1000);
+        HOST_CHECK_EQ(v, b.sample(t * 1000)); // Mesma semente, mesma sequência.
+        if (v == c.sample(t * 1000)) same++;
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+        sum += v;
+    }
+    HOST_CHECK_EQ(lo, 1998);
+    HOST_CHECK_EQ(hi, 2098);
+    HOST_CHECK_NEAR(sum / 10000, 2048, 2);
+    HOST_CHECK(same < 500); // Outra semente, outra sequência.
+    // O valor só depende do instante, não da ordem das consultas.
+    const int16_t v = a.sample(777);
+    a.sample(1);
+    HOST_CHECK_EQ(a.sample(777), v);
+}
+
+void testTraceAndRead() {
+    const int16_t trace[4] = {10, 20, 30, 40};
+    SignalSource_c sig;
+    sig.dc(1000).trace(trace, 4, 100);
+    int16_t buf[10];
+    // Amostras a cada 50 us: cada ponto do traço aparece duas vezes, e o traço se repete.
+    sig.read(buf, 10, 0, 50);
+    const int16_t expect[10] = {1010, 1010, 1020, 1020, 1030, 1030, 1040, 1040, 1010, 1010};
+    for (int i = 0; i < 10; i++) HOST_CHECK_EQ(buf[i], expect[i]);
+    // read() e sample() veem o mesmo sinal.
+    sig.read(buf, 3, 12345, 1000);
+    for (int i = 0; i < 3; i++) HOST_CHECK_EQ(buf[i], sig.sample(12345 + i * 1000));
+}
+
+int main() {
+    HOST_RUN(testDcAndRange);
+    HOST_RUN(testSine);
+    HOST_RUN(testStep);
+    HOST_RUN(testNoise);
+    HOST_RUN(testTraceAndRead);
+    return hostTestResult();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_spiffs.cpp
+ * @brief Registrador em flash: rotação de segmentos, reconstrução do índice em begin() e
+ * limpeza de arquivos inválidos.
+ *
+ * Compilado com páginas de 256 bytes, 2 páginas por segmento e até 4 segmentos
+ * (CMakeLists.txt), sobre o sistema de arquivos em RAM do shim (FS.h).
+ */
+
+#include "util/spiffs.h"
+#include "hostTest.h"
+
+WSerialmini_c ws;
+
+/**
+ * @brief Amostras por bloco: um registro de 112 amostras preenche exatamente uma página
+ * (16 + 16 + 112 * 2 = 256 bytes).
+ */
+#define BLOCK 112
+
+/**
+ * @brief Grava n blocos do canal 1, a 1 ms por amostra; a amostra k vale k.
+ */
+void appendBlocks(Logger_c &log, uint32_t first, uint32_t n) {
+    int16_t data[BLOCK];
+    for (uint32_t b = first; b < first + n; b++) {
+        for (uint8_t i = 0; i < BLOCK; i++) data[i] = (int16_t)(b * BLOCK + i);
+        HOST_CHECK(log.append(1, (uint64_t)b * BLOCK * 1000ULL, 1000, data, BLOCK));
+    }
+}
+
+/**
+ * @brief Número de arquivos em LOGGER_DIR.
+ */
+size_t logFiles() {
+    size_t n = 0;
+    for (std::map<std::string, std::vector<uint8_t> >::const_iterator it = hostFsFiles.begin(); it != hostFsFiles.end(); ++it) {
+        if (it->first.compare(0, 5, LOGGER_DIR "/") == 0) n++;
+    }
+    return n;
+}
+
+void testRotation() {
+    hostFsFiles.clear();
+    Logger_c log;
+    HOST_CHECK(log.begin());
+    HOST_CHECK_EQ(log.segments(), 1);
+    HOST_CHECK_EQ(log.segment(0).seq, 1);
+    // 20 páginas: a última fica na RAM até o próximo append(), então o segmento 10 tem uma.
+    appendBlocks(log, 0, 20);
+    HOST_CHECK_EQ(log.segments(), LOGGER_MAX_SEGMENTS);
+    HOST_CHECK_EQ(logFiles(), LOGGER_MAX_SEGMENTS);
+    // Os mais antigos foram apagados: restam os de sequência mais alta, em ordem.
+    for (uint8_t i = 1; i < log.segments(); i++) HOST_CHECK_EQ(log.segment(i).seq, log.segment(i - 1).seq + 1);
+    HOST_CHECK_EQ(log.segment(log.segments() - 1).seq, 10);
+    HOST_CHECK_EQ(log.segment(0).pages, LOGGER_SEGMENT_PAGES);
+    HOST_CHECK_EQ(log.segment(0).tFirst, 12 * BLOCK); // Segmento 7: blocos 12 e 13.
+    HOST_CHECK_EQ(log.segment(0).tLast, 14 * BLOCK - 1);
+    HOST_CHECK_EQ(log.segment(log.segments() - 1).pages, 1);
+    HOST_CHECK_EQ(log.lost(), 0);
+}
+
+void testRecovery() {
+    // Continua o registro do teste anterior em um segmento novo (11): uma página completa e
+    // outra gravada incompleta por flush() antes de "desligar".
+    {
+        Logger_c log;
+        HOST_CHECK(log.begin());
+        appendBlocks(log, 100, 1);
+        const int16_t tail[10] = {-1, -2, -3, -4, -5, -6, -7, -8, -9, -10};
+        HOST_CHECK(log.append(2, 101 * BLOCK * 1000ULL, 1000, tail, 10));
+        HOST_CHECK(log.flush());
+    }
+    Logger_c log;
+    HOST_CHECK(log.begin());
+    // O índice é remontado pelos cabeçalhos, e o mais antigo (8) dá lugar ao segmento aberto
+    // agora (12).
+    HOST_CHECK_EQ(log.segments(), LOGGER_MAX_SEGMENTS);
+    HOST_CHECK_EQ(logFiles(), LOGGER_MAX_SEGMENTS);
+    HOST_CHECK_EQ(log.segment(0).seq, 9);
+    const LogSegment_t &last = log.segment(log.segments() - 2);
+    HOST_CHECK_EQ(last.seq, 11);
+    HOST_CHECK_EQ(last.pages, 2);
+    HOST_CHECK_EQ(last.tFirst, 100 * BLOCK);
+    HOST_CHECK_EQ(last.tLast, 101 * BLOCK + 9);
+    HOST_CHECK_EQ(log.segment(log.segments() - 1).pages, 0);
+    // A página gravada por flush() continua legível.
+    Serial.tx.clear();
+    HOST_CHECK_EQ(log.dump(&ws, 101 * BLOCK, UINT32_MAX), 1);
+    HOST_CHECK(Serial.tx.find(">log2:11321:-10|g") != std::string::npos);
+}
+
+void testForeignAndCorruptFiles() {
+    hostFsFiles.clear();
+    const uint8_t junk[4] = {1, 2, 3, 4};
+    hostFsFiles["/log/readme.txt"].assign(junk, junk + 4);
+    hostFsFiles["/log/7.bin"].assign(junk, junk + 4);
+    hostFsFiles["/log/00000005.bin"].assign(junk, junk + 4); // Nome de segmento, conteúdo inválido.
+    Logger_c log;
+    HOST_CHECK(log.begin());
+    // O segmento corrompido é apagado pelo próprio nome; os demais arquivos não são do registrador.
+    HOST_CHECK(hostFsFiles.count("/log/00000005.bin") == 0);
+    HOST_CHECK(hostFsFiles.count("/log/readme.txt") == 1);
+    HOST_CHECK(hostFsFiles.count("/log/7.bin") == 1);
+    HOST_CHECK_EQ(log.segments(), 1);
+    HOST_CHECK_EQ(log.segment(0).seq, 1);
+}
+
+void testBoundedScan() {
+    hostFsFiles.clear();
+    const uint8_t junk[4] = {1, 2, 3, 4};
+    char path[32];
+    for (uint32_t seq = 1; seq <= 40; seq++) {
+        sprintf(path, LOGGER_DIR "/%08lu.bin", (unsigned long)seq);
+        hostFsFiles[path].assign(junk, junk + 4);
+    }
+    // Com remove() falhando, cada varredura anota os mesmos arquivos: begin() precisa terminar.
+    hostFsRemoveFails = true;
+    {
+        Logger_c log;
+        log.begin();
+    }
+    hostFsRemoveFails = false;
+    // Cada varredura apaga até LOGGER_MAX_SEGMENTS arquivos; o primeiro deles é recriado
+    // como o segmento aberto por begin().
+    Logger_c log;
+    HOST_CHECK(log.begin());
+    HOST_CHECK_EQ(logFiles(), 40 - LOGGER_SCAN_PASSES * LOGGER_MAX_SEGMENTS + 1);
+    HOST_CHECK_EQ(log.segments(), 1);
+}
+
+int main() {
+    Serial.begin(115200);
+    HOST_RUN(testRotation);
+    HOST_RUN(testRecovery);
+    HOST_RUN(testForeignAndCorruptFiles);
+    HOST_RUN(testBoundedScan);
+    return hostTestResult();
+}
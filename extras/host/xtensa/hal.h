@@ -0,0 +1,13 @@
+/**
+ * @file hal.h
+ * @brief Contador de ciclos do Xtensa para o build no host (ciclos a 240 MHz do relógio virtual).
+ */
+
+#ifndef HOST_XTENSA_HAL_H
+#define HOST_XTENSA_HAL_H
+
+#include <Arduino.h>
+
+inline uint32_t xthal_get_ccount(void) { return (uint32_t)(_hostMicros * 240ULL); }
+
+#endif
@@ -12,150 +12,462 @@
 
 #include <Arduino.h>
 
+#include <type_traits>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
 #include "services/display_c.h"
 #include "services/ads1115_c.h"
-#include "services/WSerialmini_c.h"
-
-/********** GPIO DEFINITIONS ***********/
-#define def_pin_ADC1 36    ///< GPIO para entrada ADC1. ADC1_CHANNEL_0
-#define def_pin_ADC2 39    ///< GPIO para entrada ADC2. ADC1_CHANNEL_3
-#define def_pin_RTN2 35    ///< GPIO para botão retentivo 2.
-#define def_pin_PUSH1 34   ///< GPIO para botão push 1.
-#define def_pin_PWM 33     ///< GPIO para saída PWM.
-#define def_pin_PUSH2 32    ///< GPIO para botão push 2.
-#define def_pin_RELE 27    ///< GPIO para relé.
-#define def_pin_W4a20_1 26 ///< GPIO para saída 4-20mA 1.
-#define def_pin_DAC1 25    ///< GPIO para saída DAC1.
-#define def_pin_D1 23      ///< GPIO para I/O digital 1.
-#define def_pin_SCL 22     ///< GPIO para SCL do display OLED.
-#define def_pin_SDA 21     ///< GPIO para SDA do display OLED.
-#define def_pin_D2 19      ///< GPIO para I/O digital 2.
-#define def_pin_D3 18      ///< GPIO para I/O digital 3.
-///< GPIO15 - ESP_PROG_TDO:6
-///< GPIO14 - ESP_PROG_TMS:2
-///< GPIO13 - ESP_PROG_TCK:4
-///< GPIO12 - ESP_PROG_TDI:8
-#define def_pin_D4 4      ///< GPIO para I/O digital 4.
-///< GPIO3  - ESP_COM_TX:3
-#define def_pin_RTN1 2    ///< GPIO para botão retentivo 1.
-///< GPIO1  - ESP_COM_RX:5
-///< GPIO0  - ESP_COM_BOOT:6
-///< ESPEN  - ESP_COM_EN:1
+#include "services/wserialmini_c.h"
+#include "services/nullDevices_c.h"
+#include "util/iikitBoard.h"
+#include "util/iikitConfig.h"
+#include "util/ledcOut.h"
+#include "util/gpioFast.h"
+#include "util/jprof.h"
+#include "util/jboot.h"
+#if defined(IIKIT_LOW_POWER) && !defined(IIKIT_EVENT_LOOP)
+#define IIKIT_EVENT_LOOP ///< O modo de baixo consumo usa o loop de eventos.
+#endif
+#ifdef IIKIT_EVENT_LOOP
+#include "util/jevent.h"
+#endif
+#ifdef IIKIT_LOW_POWER
+#include "util/jsleep.h"
+#endif
+#include "util/hartPoll.h"
+
+#ifndef IIKIT_LOOP_BUDGET_US
+#define IIKIT_LOOP_BUDGET_US 10000 ///< Orçamento de tempo (us) de uma iteração do loop, usado pelo jprof.
+#endif
+
+#ifndef IIKIT_ADS_RATE
+#ifdef IIKIT_LOW_POWER
+#define IIKIT_ADS_RATE RATE_ADS1115_8SPS   ///< Varredura lenta: o chip dorme entre as conversões.
+#else
+#define IIKIT_ADS_RATE RATE_ADS1115_860SPS ///< Taxa de conversão da varredura do ADS1115.
+#endif
+#endif
+
+#ifndef IIKIT_BOOT_STACK
+#define IIKIT_BOOT_STACK 4096 ///< Pilha da tarefa que inicializa display e ADS1115 (exceto com IIKIT_SYNC_BOOT).
+#endif
+
+#ifndef IIKIT_DISPLAY_PERIOD_US
+#define IIKIT_DISPLAY_PERIOD_US 50000 ///< Período de atualização do display no modo IIKIT_EVENT_LOOP.
+#endif
 
 /**
- * @class IIKitmini_c
+ * @class IIKitmini_t
  * @brief Classe para gerenciamento do kit industrial sem wifi.
+ *
+ * @tparam Board Descritor da placa (IIKitminiBoard ou derivado). Periféricos ausentes no
+ * descritor são trocados pelas classes vazias de nullDevices_c.h e saem do firmware.
  */
-class IIKitmini_c
+template <class Board>
+class IIKitmini_t
 {
 private:
-    ADS1115_c ads;                  ///< Conversor ADC.
+    typename std::conditional<Board::hasAds1115, ADS1115_c, NullADS1115_c>::type ads; ///< Conversor ADC.
+    static IIKitmini_t *_self; ///< Instância usada pelos handlers do loop de eventos.
+    volatile bool _ready = false; ///< true quando display e ADS1115 terminaram de inicializar.
 
 public:
-    Display_c disp;    ///< Display OLED.
+    typedef Board board_t; ///< Descritor da placa.
+
+    typename std::conditional<Board::hasDisplay, Display_c, NullDisplay_c>::type disp; ///< Display OLED.
     WSerialmini_c WSerial; ///< Conexão Telnet e Serial.
+    LedcOut_c pwm;     ///< Saída PWM (Board::pinPWM) no canal Board::ledcPwmChannel do LEDC.
+    LedcOut_c out4a20; ///< Saída 4-20mA (Board::pinW4a20_1) no canal Board::ledc4a20Channel, 1 kHz e 16 bits.
+    typename std::conditional<Board::hasHart, HartPoll_c, NullHartPoll_c>::type hart; ///< Polling HART com cache das variáveis dinâmicas (defina IIKIT_HART).
 
     /**
      * @brief Inicializa o kit industrial.
+     *
+     * As saídas vão para o estado seguro primeiro, por escrita direta nos registradores;
+     * depois vêm serial, LEDC, HART, display e ADS1115. Cada etapa é medida por jboot.h
+     * (comando "boot").
+     *
+     * O setup() retorna logo após o HART; display e ADS1115 são inicializados por uma
+     * tarefa em segundo plano. Até IIKit.ready() retornar true o loop não os consulta e
+     * analogReadPot1() e demais leituras retornam 0. Sketches que usam o display ou as
+     * leituras logo após o setup() chamam waitReady() ou usam display(). Com IIKIT_SYNC_BOOT
+     * definido, tudo é inicializado dentro do próprio setup().
      */
     void setup();
 
+    /**
+     * @brief Retorna true quando display e ADS1115 terminaram de inicializar.
+     */
+    bool ready(void) const { return _ready; }
+
+    /**
+     * @brief Aguarda display e ADS1115 terminarem de inicializar, cedendo a CPU a cada tick.
+     * @param timeoutMs Espera máxima em ms (padrão: sem limite).
+     * @return true se o kit ficou pronto dentro do prazo.
+     */
+    bool waitReady(uint32_t timeoutMs = UINT32_MAX);
+
+    /**
+     * @brief Acesso ao display que aguarda o fim da inicialização (waitReady()).
+     */
+    decltype(disp) &display(void) {
+        waitReady();
+        return disp;
+    }
+
     /**
      * @brief Executa o loop principal do kit industrial.
+     *
+     * Com IIKIT_EVENT_LOOP definido, bloqueia em jeventWait() até chegar um comando pela
+     * serial, vencer uma conversão do ADS1115, o período do display ou outro evento
+     * registrado pela aplicação (jevent.h), em vez de consultar tudo a cada chamada.
+     * Com IIKIT_LOW_POWER definido, dorme em light sleep entre os eventos (jsleep.h).
      */
     void loop(void);
 
     /**
-     * @brief Lê o valor do potenciômetro 1.
+     * @brief Lê o valor do potenciômetro 1 (última conversão da varredura do ADS1115, sem bloquear).
      * @return Valor analógico do potenciômetro 1.
      */
     uint16_t analogReadPot1(void);
 
     /**
-     * @brief Lê o valor do potenciômetro 2.
+     * @brief Lê o valor do potenciômetro 2 (última conversão da varredura do ADS1115, sem bloquear).
      * @return Valor analógico do potenciômetro 2.
      */
     uint16_t analogReadPot2(void);
 
     /**
-     * @brief Lê o valor do canal 4-20mA 1.
+     * @brief Lê o valor do canal 4-20mA 1 (última conversão da varredura do ADS1115, sem bloquear).
      * @return Valor analógico do canal 4-20mA 1.
      */
     uint16_t analogRead4a20_1(void);
 
     /**
-     * @brief Lê o valor do canal 4-20mA 2.
+     * @brief Lê o valor do canal 4-20mA 2 (última conversão da varredura do ADS1115, sem bloquear).
      * @return Valor analógico do canal 4-20mA 2.
      */
     uint16_t analogRead4a20_2(void);
+
+    /**
+     * @brief Escreve na saída PWM.
+     * @param fraction Duty como fração do período (0.0 a 1.0).
+     */
+    void pwmWrite(float fraction);
+
+    /**
+     * @brief Escreve na saída 4-20mA usando a calibração gravada na configuração.
+     * @param mA Corrente desejada em mA.
+     */
+    void write4a20(float mA);
+
+    /**
+     * @brief Inicia uma rampa por hardware na saída 4-20mA (não bloqueia).
+     * @param mA Corrente final em mA.
+     * @param ms Duração da rampa em milissegundos.
+     */
+    void fade4a20(float mA, uint32_t ms);
+
+    /**
+     * @brief Substitui um canal do ADS1115 por uma fonte de amostras (NULL volta ao conversor).
+     * @param channel Canal do ADS1115 (0 a 3).
+     * @param source Fonte de amostras (sampleSource.h).
+     */
+    void setAdsSource(uint8_t channel, SampleSource_c *source);
+
+private:
+    /**
+     * @brief Converte corrente (mA) em fração de duty pela calibração de dois pontos.
+     */
+    float fraction4a20(float mA);
+
+    /**
+     * @brief Leva todas as saídas ao estado seguro (desligadas).
+     */
+    void safeOutputs(void);
+
+    /**
+     * @brief Inicialização lenta: display e detecção do ADS1115 pelo I2C.
+     */
+    void startPeripherals(void);
+
+    /**
+     * @brief Corpo da tarefa de inicialização em segundo plano.
+     */
+    static void bootTask(void *arg);
+
+#ifdef IIKIT_EVENT_LOOP
+    /**
+     * @brief Registra serial, display, ADS1115 e HART como origens do loop de eventos.
+     */
+    void setupEvents(void);
+#endif
 };
 
-void IIKitmini_c::setup()
+template <class Board>
+IIKitmini_t<Board> *IIKitmini_t<Board>::_self = NULL;
+
+template <class Board>
+void IIKitmini_t<Board>::setup()
 {
+    _self = this;
+    /********** Saídas em estado seguro ***********/
+    uint8_t stage = jbootBegin("outputs");
+    safeOutputs();
+    jbootEnd(stage);
+    /********** Carregando configuração ***********/
+    stage = jbootBegin("config");
+    const bool cfgLoaded = configLoad();
+    jbootEnd(stage);
     /****** Inicializando Telnet|Serial***********/
-    startWSerialmini(&WSerial, 115200UL);  
+    stage = jbootBegin("serial");
+    startWSerialmini(&WSerial, IIKitCfg.serialBaud);  
     WSerial.println("Booting");
-    /********** Inicializando Display ***********/
-    if (startDisplay(&disp, def_pin_SDA, def_pin_SCL))
-    {
-        disp.setText(1, "Inicializando...");
-        WSerial.println("Display running");
+    WSerial.println(cfgLoaded ? "Config loaded" : "Config default");
+    WSerial.addCommand("cfg", [](WSerialmini_c *ws, String args) { configCommand(*ws, args); });
+    WSerial.addCommand("boot", [](WSerialmini_c *ws, String args) { jbootCommand(*ws, args); });
+#ifdef IIKIT_PROFILE
+    WSerial.addCommand("prof", [](WSerialmini_c *ws, String args) { jprofCommand(*ws, args); });
+#endif
+#ifdef IIKIT_LOW_POWER
+    WSerial.addCommand("sleep", [](WSerialmini_c *ws, String args) { jsleepCommand(*ws, args); });
+#endif
+    jbootEnd(stage);
+    /********** Configurando GPIOs ***********/
+    stage = jbootBegin("io");
+    pinMode(Board::pinRTN1, INPUT_PULLDOWN);
+    pinMode(Board::pinRTN2, INPUT_PULLDOWN);
+    pinMode(Board::pinPUSH1, INPUT_PULLDOWN);
+    pinMode(Board::pinPUSH2, INPUT_PULLDOWN);
+    if (Board::hasAdcDma) pinMode(Board::pinADC1, ANALOG);
+    if (!pwm.begin(Board::pinPWM, Board::ledcPwmChannel, Board::ledcPwmTimer, IIKitCfg.pwmFreq, IIKitCfg.pwmBits)) {
+        WSerial.println("WARN: PWM nao configurado (pwmFreq/pwmBits)");
+    }
+    pwm.write(0);
+    if (!out4a20.begin(Board::pinW4a20_1, Board::ledc4a20Channel, Board::ledc4a20Timer, 1000, 16)) {
+        WSerial.println("WARN: saida 4-20mA nao configurada");
+    }
+    out4a20.write(0);
+    hart.begin();
+    jbootEnd(stage);
+#ifdef IIKIT_EVENT_LOOP
+    setupEvents();
+#endif
+    /********** Display e ADS1115 ***********/
+#ifndef IIKIT_SYNC_BOOT
+    if (!(Board::hasDisplay || Board::hasAds1115)) {
+        _ready = true;
+    } else if (xTaskCreatePinnedToCore(bootTask, "iikitBoot", IIKIT_BOOT_STACK, NULL, 1, NULL, tskNO_AFFINITY) != pdPASS) {
+        startPeripherals();
     }
-    delay(50);
+#else
+    startPeripherals();
+#endif
+}
+
+template <class Board>
+void IIKitmini_t<Board>::safeOutputs(void)
+{
+    // O nível é gravado antes de habilitar o driver: o pino já sai em LOW, sem pulso.
+    gpioWrite<Board::pinD1>(LOW);
+    gpioWrite<Board::pinD2>(LOW);
+    gpioWrite<Board::pinD3>(LOW);
+    gpioWrite<Board::pinD4>(LOW);
+    gpioWrite<Board::pinRELE>(LOW);
+    gpioWrite<Board::pinPWM>(LOW);
+    gpioWrite<Board::pinW4a20_1>(LOW);
+    pinMode(Board::pinD1, OUTPUT);
+    pinMode(Board::pinD2, OUTPUT);
+    pinMode(Board::pinD3, OUTPUT);
+    pinMode(Board::pinD4, OUTPUT);
+    pinMode(Board::pinRELE, OUTPUT);
+    pinMode(Board::pinPWM, OUTPUT);
+    pinMode(Board::pinW4a20_1, OUTPUT);
+    pinMode(Board::pinDAC1, ANALOG);
+    analogWrite(Board::pinDAC1, 0);
+}
+
+template <class Board>
+void IIKitmini_t<Board>::startPeripherals(void)
+{
+    uint8_t stage = jbootBegin("display");
     /********** Configurando Wi-Fi ***********/
     disp.setFuncMode(false);
-    disp.setText(1, "Mode: sem WIFI", false);
-    /********** Configurando GPIOs ***********/
-    pinMode(def_pin_RTN1, INPUT_PULLDOWN);
-    pinMode(def_pin_RTN2, INPUT_PULLDOWN);
-    pinMode(def_pin_PUSH1, INPUT_PULLDOWN);
-    pinMode(def_pin_PUSH2, INPUT_PULLDOWN);
-    pinMode(def_pin_D1, OUTPUT);
-    pinMode(def_pin_D2, OUTPUT);
-    pinMode(def_pin_D3, OUTPUT);
-    pinMode(def_pin_D4, OUTPUT);
-    pinMode(def_pin_PWM, OUTPUT);
-    pinMode(def_pin_DAC1, ANALOG);
-    pinMode(def_pin_ADC1, ANALOG);
-    pinMode(def_pin_RELE, OUTPUT);
-    pinMode(def_pin_W4a20_1, OUTPUT);
-    digitalWrite(def_pin_D1, LOW);
-    digitalWrite(def_pin_D2, LOW);        
-    digitalWrite(def_pin_D3, LOW);
-    digitalWrite(def_pin_D4, LOW);
-    digitalWrite(def_pin_RELE, LOW);
-    analogWrite(def_pin_PWM, 0);
-    analogWrite(def_pin_DAC1, 0);
-    analogWrite(def_pin_W4a20_1, 0);
-    ads.begin();
+    disp.setText(1, "Mode: sem WIFI", false); // Antes de startDisplay(): entra no único redesenho.
+    if (startDisplay(&disp, (uint8_t)Board::pinSDA, (uint8_t)Board::pinSCL))
+    {
+        WSerial.println("Display running");
+    }
+    jbootEnd(stage);
+    stage = jbootBegin("ads");
+    if (ads.begin((adsGain_t)((uint16_t)IIKitCfg.adsGain << 9))) {
+        ads.startScan(IIKIT_ADS_RATE);
+    } else if (Board::hasAds1115) {
+        WSerial.println("WARN: ADS1115 nao encontrado");
+    }
+    jbootEnd(stage);
+    _ready = true;
+#ifdef IIKIT_EVENT_LOOP
+    jeventSignal(JEVENT_DISPLAY); // Recalcula os prazos com o ADS1115 em varredura.
+#endif
+}
+
+template <class Board>
+bool IIKitmini_t<Board>::waitReady(uint32_t timeoutMs)
+{
+    const uint32_t t0 = millis();
+    while (!_ready) {
+        if (millis() - t0 >= timeoutMs) return false;
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+template <class Board>
+void IIKitmini_t<Board>::bootTask(void *arg)
+{
+    (void)arg;
+    _self->startPeripherals();
+    vTaskDelete(NULL);
+}
+
+#ifdef IIKIT_EVENT_LOOP
+template <class Board>
+void IIKitmini_t<Board>::setupEvents(void)
+{
+    jeventBegin();
+    Serial.onReceive([]() { jeventSignal(JEVENT_UART); });
+    jeventAttach(JEVENT_UART, [](uint32_t) {
+        JPROF_SCOPE("wserial");
+        updateWSerialmini(&_self->WSerial);
+        if (Serial.available()) jeventSignal(JEVENT_UART); // Uma linha por chamada.
+    });
+#ifdef IIKIT_LOW_POWER
+    jsleepWakeUart(0);
+#endif
+    if (Board::hasDisplay) {
+#ifdef IIKIT_LOW_POWER
+        // Sem timer do display: ele é redesenhado apenas quando o chip acorda por outro motivo.
+        jeventAttach(JEVENT_ANY, [](uint32_t) {
+#else
+        jeventTimer(IIKIT_DISPLAY_PERIOD_US, JEVENT_DISPLAY);
+        jeventAttach(JEVENT_DISPLAY, [](uint32_t) {
+#endif
+            if (!_self->_ready) return;
+            JPROF_SCOPE("display");
+            updateDisplay(&_self->disp);
+        });
+    }
+    if (Board::hasAds1115) {
+        jeventAddDeadline([]() { return _self->_ready ? _self->ads.nextDue() : UINT32_MAX; });
+        jeventAttach(JEVENT_TIMEOUT, [](uint32_t) {
+            if (!_self->_ready) return;
+            JPROF_SCOPE("ads");
+            _self->ads.scan();
+        });
+    }
+    if (Board::hasHart) {
+        Serial2.onReceive([]() { jeventSignal(JEVENT_HART); });
+        jeventAddDeadline([]() { return _self->hart.nextDue(); });
+        jeventAttach(JEVENT_HART | JEVENT_TIMEOUT, [](uint32_t) {
+            JPROF_SCOPE("hart");
+            _self->hart.update();
+        });
+    }
+}
+#endif
+
+template <class Board>
+void IIKitmini_t<Board>::loop(void)
+{
+    jbootFirstCycle();
+#if defined(IIKIT_LOW_POWER)
+    jsleepLoop();
+#elif defined(IIKIT_EVENT_LOOP)
+    jeventWait();
+#else
+    JPROF_LOOP(IIKIT_LOOP_BUDGET_US);
+    {
+        JPROF_SCOPE("wserial");
+        updateWSerialmini(&WSerial);
+    }
+    if (Board::hasDisplay && _ready) {
+        JPROF_SCOPE("display");
+        updateDisplay(&disp);
+    }
+    if (Board::hasAds1115 && _ready) {
+        JPROF_SCOPE("ads");
+        ads.scan();
+    }
+    if (Board::hasHart) {
+        JPROF_SCOPE("hart");
+        hart.update();
+    }
+#endif
+}
+
+template <class Board>
+uint16_t IIKitmini_t<Board>::analogReadPot1(void)
+{
+    if (!_ready) return 0; // O ADS1115 ainda está sendo inicializado pela tarefa de boot.
+    return ads.analogRead(Board::adsPot1);
+}
+
+template <class Board>
+uint16_t IIKitmini_t<Board>::analogReadPot2(void)
+{
+    if (!_ready) return 0;
+    return ads.analogRead(Board::adsPot2);
+}
+
+template <class Board>
+uint16_t IIKitmini_t<Board>::analogRead4a20_1(void)
+{
+    if (!_ready) return 0;
+    return ads.analogRead(Board::ads4a20_1);
+}
+
+template <class Board>
+uint16_t IIKitmini_t<Board>::analogRead4a20_2(void)
+{
+    if (!_ready) return 0;
+    return ads.analogRead(Board::ads4a20_2);
 }
 
-void IIKitmini_c::loop(void)
+template <class Board>
+void IIKitmini_t<Board>::pwmWrite(float fraction)
 {
-    updateWSerialmini(&WSerial);
-    updateDisplay(&disp);
+    pwm.writeFraction(fraction);
 }
 
-uint16_t IIKitmini_c::analogReadPot1(void)
+template <class Board>
+float IIKitmini_t<Board>::fraction4a20(float mA)
 {
-    return ads.analogRead(1);
+    return IIKitCfg.out4a20Cal4 + (mA - 4.0f) * (IIKitCfg.out4a20Cal20 - IIKitCfg.out4a20Cal4) / 16.0f;
 }
 
-uint16_t IIKitmini_c::analogReadPot2(void)
+template <class Board>
+void IIKitmini_t<Board>::write4a20(float mA)
 {
-    return ads.analogRead(0);
+    out4a20.writeFraction(fraction4a20(mA));
 }
 
-uint16_t IIKitmini_c::analogRead4a20_1(void)
+template <class Board>
+void IIKitmini_t<Board>::setAdsSource(uint8_t channel, SampleSource_c *source)
 {
-    return ads.analogRead(3);
+    ads.setSource(channel, source);
 }
 
-uint16_t IIKitmini_c::analogRead4a20_2(void)
+template <class Board>
+void IIKitmini_t<Board>::fade4a20(float mA, uint32_t ms)
 {
-    return ads.analogRead(2);
+    const float fraction = constrain(fraction4a20(mA), 0.0f, 1.0f);
+    out4a20.fade((uint32_t)(fraction * out4a20.maxDuty() + 0.5f), ms);
 }
 
+typedef IIKitmini_t<IIKIT_BOARD> IIKitmini_c; ///< Kit com o descritor escolhido por IIKIT_BOARD.
+
 IIKitmini_c IIKit;
 
 #endif
\ No newline at end of file
@@ -7,6 +7,28 @@
  */
 
 #include <Adafruit_ADS1X15.h>
+#include <esp_timer.h>
+#include "../util/sampleSource.h"
+
+#ifndef ADS1115_SCAN_TIMEOUT
+/**
+ * @brief Conversões (em múltiplos da duração estimada) após as quais uma conversão sem
+ * resposta do chip é abandonada.
+ */
+#define ADS1115_SCAN_TIMEOUT 4
+#endif
+
+#ifndef ADS1115_SCAN_BACKOFF_US
+/**
+ * @brief Espera (us) antes de reiniciar a varredura após a primeira conversão abandonada;
+ * dobra a cada nova falha consecutiva, até ADS1115_SCAN_BACKOFF_MAX_US.
+ */
+#define ADS1115_SCAN_BACKOFF_US 100000UL
+#endif
+
+#ifndef ADS1115_SCAN_BACKOFF_MAX_US
+#define ADS1115_SCAN_BACKOFF_MAX_US 1000000UL ///< Maior espera (us) entre tentativas.
+#endif
 
 /**
  * @class ADS1115_c
@@ -14,6 +36,20 @@
  *
  * Esta classe encapsula o funcionamento do ADS1115, definindo o ganho padrão
  * e oferecendo um método de leitura direta de canais analógicos.
+ *
+ * Com startScan() os quatro canais passam a ser convertidos em sequência sem bloquear:
+ * cada chamada de scan() apenas verifica se a conversão corrente terminou, guarda o
+ * resultado em cache e dispara a próxima. A partir daí analogRead() retorna o valor em
+ * cache, sem esperar a conversão, e pode ser usado por malhas de controle em timer.
+ *
+ * Se o chip parar de responder no meio da varredura, a conversão corrente é abandonada
+ * após ADS1115_SCAN_TIMEOUT vezes a sua duração e a varredura é reiniciada depois de uma
+ * espera crescente (ADS1115_SCAN_BACKOFF_US), em vez de consultar o I2C em laço; o cache
+ * mantém os últimos valores e sampleCount() para de avançar.
+ *
+ * Com setSource() um canal passa a ser lido de uma fonte sintética (sampleSource.h) no
+ * instante de esp_timer_get_time(), sem acesso ao I2C. Use SignalSource_c::range(0, 32767)
+ * para a faixa do ADS1115.
  */
 class ADS1115_c : protected Adafruit_ADS1115 {
 public:
@@ -27,12 +63,16 @@ public:
     /**
      * @brief Inicializa o dispositivo ADS1115.
      *
-     * Define o ganho padrão como GAIN_TWOTHIRDS e inicializa o dispositivo.
+     * Define o ganho (padrão GAIN_TWOTHIRDS) e inicializa o dispositivo. Se o chip não
+     * responder, startScan() não faz nada e as leituras do conversor retornam 0 (as fontes
+     * de setSource() continuam valendo), em vez de esperar uma conversão que nunca termina.
+     * @param gain Ganho do amplificador programável.
      * @return true se o dispositivo foi inicializado com sucesso, false caso contrário.
      */
-    bool begin() {
-        ((Adafruit_ADS1115 *)this)->setGain(adsGain_t::GAIN_TWOTHIRDS);
-        return ((Adafruit_ADS1115 *)this)->begin();
+    bool begin(adsGain_t gain = adsGain_t::GAIN_TWOTHIRDS) {
+        ((Adafruit_ADS1115 *)this)->setGain(gain);
+        _present = ((Adafruit_ADS1115 *)this)->begin();
+        return _present;
     }
 
     /**
@@ -42,6 +82,157 @@ public:
      * @return Valor analógico lido do canal (16 bits).
      */
     uint16_t analogRead(uint8_t channel) {
+        if (!_scanning && _source[channel & 3] != NULL) return _source[channel & 3]->sample(esp_timer_get_time());
+        if (_scanning) return _cache[channel & 3];
+        if (!_present) return 0;
         return ((Adafruit_ADS1115 *)this)->readADC_SingleEnded(channel);
     }
+
+    /**
+     * @brief Inicia a varredura não bloqueante dos canais 0 a 3.
+     *
+     * @param rate Taxa de conversão (padrão RATE_ADS1115_860SPS, cerca de 200 varreduras/s).
+     */
+    void startScan(uint16_t rate = RATE_ADS1115_860SPS) {
+        if (!_present) return; // Sem chip, nextDue() venceria sempre e scan() consultaria o I2C em laço.
+        static const uint16_t sps[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+        ((Adafruit_ADS1115 *)this)->setDataRate(rate);
+        _convUs = 1000000UL / sps[(rate >> 5) & 7] + 100; // Margem para o oscilador interno.
+        _scanCh = 0;
+        _scanning = true;
+        _backoffUs = 0;
+        startConversion();
+    }
+
+    /**
+     * @brief Avança a varredura: se a conversão corrente terminou, guarda o resultado e dispara a próxima.
+     *
+     * Deve ser chamada periodicamente no loop principal. Nunca espera a conversão.
+     */
+    void scan() {
+        if (!_scanning) return;
+        const uint32_t elapsed = micros() - _startUs;
+        if (_retry) {
+            if (elapsed < _dueUs) return;
+            _retry = false;
+            startConversion(); // Repete o canal abandonado.
+            return;
+        }
+        if (_source[_scanCh] != NULL) {
+            _time[_scanCh] = esp_timer_get_time();
+            _cache[_scanCh] = _source[_scanCh]->sample(_time[_scanCh]);
+        } else {
+            if (!((Adafruit_ADS1115 *)this)->conversionComplete()) {
+                if (elapsed >= _convUs * ADS1115_SCAN_TIMEOUT) {
+                    // O chip não responde: espera antes de tentar de novo.
+                    _timeouts++;
+                    _backoffUs = (_backoffUs == 0) ? ADS1115_SCAN_BACKOFF_US : min(2 * _backoffUs, (uint32_t)ADS1115_SCAN_BACKOFF_MAX_US);
+                    _retry = true;
+                    _startUs = micros();
+                    _dueUs = _backoffUs;
+                } else {
+                    // Oscilador mais lento que a margem: consulta de novo daqui a 1/4 de conversão.
+                    _dueUs = min(elapsed + _convUs / 4, _convUs * ADS1115_SCAN_TIMEOUT);
+                }
+                return;
+            }
+            _backoffUs = 0;
+            _cache[_scanCh] = ((Adafruit_ADS1115 *)this)->getLastConversionResults();
+            // O delta-sigma integra durante toda a conversão: a amostra vale pelo meio dela.
+            _time[_scanCh] = _startTime + (_convUs - 100) / 2;
+        }
+        _stamp[_scanCh] = micros();
+        _seq[_scanCh]++;
+        _scanCh = (_scanCh + 1) & 3;
+        startConversion();
+    }
+
+    /**
+     * @brief Retorna o tempo (us) até scan() ter trabalho: fim da conversão corrente, nova
+     * consulta de uma conversão atrasada ou fim da espera após o chip parar de responder.
+     *
+     * Usado pelo loop de eventos para chamar scan() só quando há resultado a buscar.
+     * @return 0 se scan() já deve ser chamada, UINT32_MAX fora da varredura.
+     */
+    uint32_t nextDue() const {
+        if (!_scanning) return UINT32_MAX;
+        const uint32_t elapsed = micros() - _startUs;
+        return (elapsed >= _dueUs) ? 0 : _dueUs - elapsed;
+    }
+
+    /**
+     * @brief Retorna quantas conversões foram abandonadas por falta de resposta do chip.
+     */
+    uint32_t timeouts() const {
+        return _timeouts;
+    }
+
+    /**
+     * @brief Substitui a leitura de um canal por uma fonte de amostras (NULL volta ao ADS1115).
+     *
+     * @param channel Canal (0 a 3).
+     * @param source Fonte de amostras, por exemplo um SignalSource_c.
+     */
+    void setSource(uint8_t channel, SampleSource_c *source) {
+        _source[channel & 3] = source;
+    }
+
+    /**
+     * @brief Retorna o instante (micros) da última conversão em cache do canal.
+     */
+    uint32_t timestamp(uint8_t channel) const {
+        return _stamp[channel & 3];
+    }
+
+    /**
+     * @brief Retorna o instante (us, esp_timer) da amostra em cache do canal.
+     *
+     * Mesma base de tempo de jBlock_t::t0 (AdcDmaEsp.h), para alinhar as fontes.
+     */
+    uint64_t sampleTime(uint8_t channel) const {
+        return _time[channel & 3];
+    }
+
+    /**
+     * @brief Retorna quantas conversões do canal já entraram no cache.
+     *
+     * Comparando com o valor lido anteriormente, o chamador sabe se há amostra nova ou
+     * quantas perdeu.
+     */
+    uint32_t sampleCount(uint8_t channel) const {
+        return _seq[channel & 3];
+    }
+
+protected:
+    /**
+     * @brief Inicia a conversão do canal corrente (ou só marca o instante, se for sintético).
+     */
+    void startConversion() {
+        _startUs = micros();
+        _startTime = esp_timer_get_time();
+        _dueUs = _convUs;
+        if (_source[_scanCh] == NULL) ((Adafruit_ADS1115 *)this)->startADCReading(muxByChannel(_scanCh), false);
+    }
+
+    static uint16_t muxByChannel(uint8_t channel) {
+        static const uint16_t mux[4] = {ADS1X15_REG_CONFIG_MUX_SINGLE_0, ADS1X15_REG_CONFIG_MUX_SINGLE_1,
+                                        ADS1X15_REG_CONFIG_MUX_SINGLE_2, ADS1X15_REG_CONFIG_MUX_SINGLE_3};
+        return mux[channel];
+    }
+
+    bool _present = false;              ///< true se begin() encontrou o chip.
+    bool _scanning = false;             ///< true após startScan().
+    uint8_t _scanCh = 0;                ///< Canal em conversão.
+    volatile int16_t _cache[4] = {0};   ///< Última conversão de cada canal.
+    volatile uint32_t _stamp[4] = {0};  ///< Instante (micros) de cada conversão em cache.
+    uint32_t _convUs = 1263;            ///< Duração estimada de uma conversão (us).
+    uint32_t _startUs = 0;              ///< Instante (micros) de início da conversão corrente (ou da espera).
+    uint32_t _dueUs = 1263;             ///< Tempo (us) após _startUs em que scan() tem trabalho.
+    bool _retry = false;                ///< true durante a espera após uma conversão abandonada.
+    uint32_t _backoffUs = 0;            ///< Espera corrente (us); 0 sem falhas consecutivas.
+    uint32_t _timeouts = 0;             ///< Conversões abandonadas.
+    int64_t _startTime = 0;             ///< Instante (esp_timer) de início da conversão corrente.
+    volatile uint64_t _time[4] = {0};   ///< Instante (esp_timer) de cada amostra em cache.
+    volatile uint32_t _seq[4] = {0};    ///< Conversões de cada canal desde o início.
+    SampleSource_c *_source[4] = {NULL, NULL, NULL, NULL}; ///< Fontes sintéticas por canal.
 };
@@ -14,7 +14,16 @@
 #define SCREEN_HEIGHT 64    ///< Altura do display em pixels.
 #define OLED_RESET -1       ///< Pino de reset (ou -1 para compartilhar com o reset do Arduino).
 
-Adafruit_SSD1306 SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+/**
+ * @brief Retorna o driver do display, criado no primeiro uso.
+ *
+ * Construído sob demanda para que placas sem display (IIKitminiBoard::hasDisplay = false)
+ * não carreguem o objeto nem seu construtor estático.
+ */
+inline Adafruit_SSD1306 &oled(void) {
+    static Adafruit_SSD1306 SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+    return SSD1306;
+}
 
 /**
  * @class Display_c
@@ -28,6 +37,14 @@ protected:
      */
     void rotaty(uint8_t index);
 
+    /**
+     * @brief Grava o texto de uma linha sem redesenhar o display.
+     * @param index Índice da linha (0 a 2).
+     * @param txt Texto a ser exibido.
+     * @param txtSize Tamanho da fonte.
+     */
+    void setLine(uint8_t index, const char txt[], uint8_t txtSize);
+
     /**
      * @brief Inicializa o display OLED.
      * @param SDA Pino SDA para comunicação I2C.
@@ -41,6 +58,7 @@ protected:
      */
     void update(void);
 
+    bool isStarted = false; ///< true após start(); antes disso o texto só é gravado, sem redesenho.
     bool isFuncMode = false; ///< Indica se o display está no modo de função.
     bool isChanged = true; ///< Indica se houve alteração no conteúdo do display.
     bool scrollLeft[3] = {false, false, false}; ///< Flags de rolagem para cada linha.
@@ -53,6 +71,8 @@ protected:
 public:
     /**
      * @brief Configura o texto a ser exibido em uma linha do display.
+     *
+     * Antes de startDisplay() o texto só é gravado e entra no redesenho inicial.
      * @param line Índice da linha (1 a 3).
      * @param txt Texto a ser exibido.
      * @param funcMode Modo de função (opcional).
@@ -90,12 +110,16 @@ bool Display_c::start(const uint8_t &SDA, const uint8_t &SCL) {
     if (SDA != 0 && SCL != 0) {
         Wire.setPins(SDA, SCL);
     }
-    if (!SSD1306.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+    if (!oled().begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
         return false;
     }
-    setText(1, ca_lineTxt[0]);
-    setText(2, ca_lineTxt[1]);
-    setText(3, ca_lineTxt[2]);
+    // Um único redesenho, com o texto gravado antes: cada transferência do quadro pelo I2C
+    // leva dezenas de ms.
+    for (uint8_t i = 0; i < 3; i++) {
+        setLine(i, ca_lineTxt[i], 2);
+    }
+    isStarted = true;
+    update();
     return true;
 }
 
@@ -104,24 +128,25 @@ inline void updateDisplay(Display_c *disp) {
 }
 
 void Display_c::update(void) {
+    if (!isStarted) return;
     if (ui8_lineSize[0] > 10 || ui8_lineSize[1] > 10 || ui8_lineSize[2] > 10 || isChanged) {
         isChanged = false;
-        SSD1306.clearDisplay();
-        SSD1306.setTextWrap(false);
-        SSD1306.setTextColor(SSD1306_WHITE);
-        SSD1306.cp437(true);
+        oled().clearDisplay();
+        oled().setTextWrap(false);
+        oled().setTextColor(SSD1306_WHITE);
+        oled().cp437(true);
         rotaty(0);
         rotaty(1);
         rotaty(2);
-        SSD1306.display();
+        oled().display();
     }
 }
 
 void Display_c::rotaty(uint8_t index) {
     if (ui8_lineSize[index] > 10) {
-        SSD1306.setTextSize(ui8_txtSize[index]);
-        SSD1306.setCursor(i16_lineWidth[index], index * 20);
-        SSD1306.print(ca_lineTxt[index]);
+        oled().setTextSize(ui8_txtSize[index]);
+        oled().setCursor(i16_lineWidth[index], index * 20);
+        oled().print(ca_lineTxt[index]);
         if (scrollLeft[index]) {
             ++i16_lineWidth[index];
         } else {
@@ -134,23 +159,27 @@ void Display_c::rotaty(uint8_t index) {
             scrollLeft[index] = false;
         }
     } else {
-        SSD1306.setTextSize(ui8_txtSize[index]);
-        SSD1306.setCursor(0, index * 20);
-        SSD1306.println(ca_lineTxt[index]);
+        oled().setTextSize(ui8_txtSize[index]);
+        oled().setCursor(0, index * 20);
+        oled().println(ca_lineTxt[index]);
     }
 }
 
 void Display_c::setText(uint8_t line, const char txt[], bool funcMode, uint8_t txtSize) {
     if (this->isFuncMode == funcMode) {
-        strcpy(ca_lineTxt[line - 1], txt);
-        ui8_lineSize[line - 1] = strlen(ca_lineTxt[line - 1]);
-        i16_lineMinWidth[line - 1] = -12 * (ui8_lineSize[line - 1] - 9);
-        ui8_txtSize[line - 1] = txtSize;
-        isChanged = true;
+        setLine(line - 1, txt, txtSize);
     }
     update();
 }
 
+void Display_c::setLine(uint8_t index, const char txt[], uint8_t txtSize) {
+    if (txt != ca_lineTxt[index]) strcpy(ca_lineTxt[index], txt);
+    ui8_lineSize[index] = strlen(ca_lineTxt[index]);
+    i16_lineMinWidth[index] = -12 * (ui8_lineSize[index] - 9);
+    ui8_txtSize[index] = txtSize;
+    isChanged = true;
+}
+
 void Display_c::setFuncMode(bool funcMode) {
     this->isFuncMode = funcMode;
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ * @file nullDevices_c.h
+ * @brief Substitutos vazios dos periféricos opcionais do kit.
+ *
+ * Quando o descritor da placa desabilita um periférico (hasDisplay, hasAds1115, hasHart),
+ * IIKitmini_t usa a classe correspondente deste arquivo: mesma interface, métodos vazios
+ * inline, sem membros. O compilador elimina as chamadas e nenhum código ou RAM do
+ * periférico real é incluído no firmware.
+ */
+
+#ifndef __NULL_DEVICES_C_H
+#define __NULL_DEVICES_C_H
+
+#include <Arduino.h>
+#include "../util/sampleSource.h"
+#include "../util/hartPoll.h"
+
+/**
+ * @class NullDisplay_c
+ * @brief Placa sem display.
+ */
+class NullDisplay_c {
+public:
+    inline void setText(uint8_t, const char[], bool = false, uint8_t = 2) {}
+    inline void setFuncMode(bool) {}
+};
+
+inline bool startDisplay(NullDisplay_c *, const uint8_t &, const uint8_t &) { return false; }
+inline void updateDisplay(NullDisplay_c *) {}
+
+/**
+ * @class NullADS1115_c
+ * @brief Placa sem ADS1115: leituras retornam 0.
+ */
+class NullADS1115_c {
+public:
+    template <typename G>
+    inline bool begin(G) { return false; }
+    inline void startScan(uint16_t = 0) {}
+    inline void scan() {}
+    inline uint16_t analogRead(uint8_t) { return 0; }
+    inline uint32_t timestamp(uint8_t) const { return 0; }
+    inline uint64_t sampleTime(uint8_t) const { return 0; }
+    inline uint32_t sampleCount(uint8_t) const { return 0; }
+    inline uint32_t nextDue() const { return UINT32_MAX; }
+    inline void setSource(uint8_t, SampleSource_c *) {}
+};
+
+/**
+ * @class NullHartPoll_c
+ * @brief Placa sem modem HART.
+ */
+class NullHartPoll_c {
+public:
+    inline void begin(int8_t = 16, int8_t = 17) {}
+    inline int8_t addDevice(uint8_t, uint32_t = 1000) { return -1; }
+    inline void update() {}
+    inline uint32_t nextDue() const { return UINT32_MAX; }
+    inline const HartDevice_t *device(int8_t) const { return NULL; }
+    inline const HartDynVars_t *vars(int8_t) const { return NULL; }
+    inline float pv(int8_t) const { return NAN; }
+    inline uint32_t age(int8_t) const { return UINT32_MAX; }
+    inline uint8_t count() const { return 0; }
+};
+
+#endif
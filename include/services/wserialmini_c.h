@@ -4,21 +4,33 @@
 #include <Arduino.h>
 
 #define BAUD_RATE 115200UL
+#ifndef WSERIAL_MAX_COMMANDS
+#define WSERIAL_MAX_COMMANDS 8 ///< Número máximo de comandos registrados com addCommand().
+#endif
 class WSerialmini_c
 {
   typedef void (*CallbackFunction)(String str);
+public:
+  typedef void (*CommandFunction)(WSerialmini_c *ws, String args);
 protected: 
   uint64_t _count = 0;
   void update(void);
   void start(unsigned long baudrate);
+  bool dispatch(String line);
   CallbackFunction on_input = NULL;
+  const char *_cmdName[WSERIAL_MAX_COMMANDS];
+  CommandFunction _cmdFunc[WSERIAL_MAX_COMMANDS];
+  uint8_t _nCommands = 0;
 
 public:
   WSerialmini_c() {};
   void onInput(CallbackFunction f);
+  bool addCommand(const char *name, CommandFunction f);
   template <typename T>
   void plot(const char *varName, uint32_t x, T y, size_t ylen, const char *unit  = NULL); 
   template <typename T>
+  void plot(const char *varName, uint64_t t0, uint32_t period, T y, size_t ylen, const char *unit = NULL);
+  template <typename T>
   void plot(const char *varName, uint32_t x, T y, const char *unit = NULL);
   template <typename T>
   void plot(const char *varName, T y, const char *unit = NULL);
@@ -31,6 +43,7 @@ public:
   void println(const T &data);
   template <typename T>
   void println(const T &data, int base);
+  size_t write(const uint8_t *buffer, size_t size);
 
   
   friend inline void startWSerialmini(WSerialmini_c *ws, unsigned long baudrate);
@@ -47,12 +60,46 @@ void WSerialmini_c::onInput(CallbackFunction f) {
   on_input = f;
 }  
 
+/**
+ * @brief Registra um comando de linha. Linhas iniciadas por name são entregues a f
+ * (com o restante da linha em args) em vez de irem para o callback de onInput().
+ * @return false (e um aviso na serial) se a tabela já tiver WSERIAL_MAX_COMMANDS comandos.
+ */
+bool WSerialmini_c::addCommand(const char *name, CommandFunction f) {
+  if (_nCommands >= WSERIAL_MAX_COMMANDS) {
+    Serial.print("WARN: comando nao registrado (WSERIAL_MAX_COMMANDS): ");
+    Serial.println(name);
+    return false;
+  }
+  _cmdName[_nCommands] = name;
+  _cmdFunc[_nCommands] = f;
+  _nCommands++;
+  return true;
+}
+
+bool WSerialmini_c::dispatch(String line)
+{
+  line.trim();
+  const int sp = line.indexOf(' ');
+  const String name = (sp < 0) ? line : line.substring(0, sp);
+  for (uint8_t i = 0; i < _nCommands; i++)
+  {
+    if (name == _cmdName[i])
+    {
+      _cmdFunc[i](this, (sp < 0) ? String("") : line.substring(sp + 1));
+      return true;
+    }
+  }
+  return false;
+}
+
 inline void updateWSerialmini(WSerialmini_c *ws) {ws->update();}
 void WSerialmini_c::update(void)
 {
-  if (Serial.available() && on_input != NULL)
+  if (Serial.available() && (on_input != NULL || _nCommands > 0))
   {
-    on_input(Serial.readStringUntil('\n'));
+    String line = Serial.readStringUntil('\n');
+    if (!dispatch(line) && on_input != NULL) on_input(line);
   }
 }
 
@@ -77,6 +124,39 @@ void WSerialmini_c::plot(const char *varName, uint32_t x, T y, size_t ylen, cons
   println("|g"); // Modo Grafico  
 }
 
+/**
+ * @brief Envia um bloco de amostras com o instante real de cada uma.
+ *
+ * O eixo x é o instante em ms (com resolução de us) de cada amostra, t0 + i * period, em
+ * vez de um contador: blocos perdidos aparecem como lacunas e fontes diferentes ficam
+ * alinhadas. Para um bloco do pool: plot("adc", b->t0, b->period, b->data, b->count).
+ * @param t0 Instante (us, esp_timer) da primeira amostra.
+ * @param period Período de amostragem em us.
+ */
+template <typename T>
+void WSerialmini_c::plot(const char *varName, uint64_t t0, uint32_t period, T y, size_t ylen, const char *unit)
+{
+  print(">"); // Inicio de envio de dados para um gráfico.
+  print(varName);
+  print(":");
+  char x[24];
+  for (size_t i = 0; i < ylen; i++)
+  {
+      const uint64_t t = t0 + (uint64_t)i * period;
+      snprintf(x, sizeof(x), "%lu.%03u", (unsigned long)(t / 1000ULL), (unsigned)(t % 1000ULL));
+      print(x);
+      print(":");
+      print( (uint16_t) (abs(y[i]) & 0x0FFF));
+      if(i < ylen -1) print(";");
+  }
+  if (unit != NULL)
+  {
+    print("§"); // Unidade na sequência
+    print(unit);
+  }
+  println("|g"); // Modo Grafico  
+}
+
 template <typename T>
 void WSerialmini_c::plot(const char *varName, T y, const char *unit)
 {
@@ -127,4 +207,9 @@ void WSerialmini_c::println()
 {
     Serial.println();
 }
+
+size_t WSerialmini_c::write(const uint8_t *buffer, size_t size)
+{
+    return Serial.write(buffer, size);
+}
 #endif
\ No newline at end of file
@@ -9,6 +9,14 @@
  * Esta biblioteca permite a leitura de dados analógicos usando o periférico I2S
  * com DMA para aquisição de alta performance. Caso seja detectado o endereço MAC
  * 24:0A:C4:00:01:10 (simulador Wokwi), ativa o modo fallback para leitura direta do ADC.
+ *
+ * Com adcDmaSetSource() as amostras passam a vir de uma fonte sintética (sampleSource.h)
+ * em vez do ADC: cada callback recebe callbackPeriod / samplePeriod amostras espaçadas de
+ * exatamente samplePeriod. O relógio dessas amostras parte do esp_timer no primeiro bloco,
+ * o mesmo do ADS1115_c e do DigitalINDebounce, então as fontes ficam alinhadas no tempo.
+ *
+ * Com adcDmaAttachQueue() cada aquisição é lida direto em um bloco de jpool.h e entregue
+ * por uma fila, liberando o processamento e a transmissão para rodar em paralelo.
  */
 
 #ifndef ADCDMAESP_H
@@ -18,6 +26,14 @@
 #include <Arduino.h>
 #include <esp_system.h>  // Necessário para esp_read_mac
 #include <esp_wifi.h>    // Para ESP_MAC_WIFI_STA
+#include "jprof.h"
+#include "sampleSource.h"
+#include "jpool.h"
+#include "jqueue.h"
+#include "jevent.h"
+#include "jclock.h"
+#include "iikitConfig.h"
+#include <esp_timer.h>
 
 #define CHANNEL_ADC1 ADC1_CHANNEL_0
 #define CHANNEL_ADC2 ADC1_CHANNEL_3
@@ -54,6 +70,8 @@ __attribute__((aligned(16))) int16_t dma_buffer[DMA_BUFFERS * BUFFER_LEN];
  */
 int16_t fallback_buffer[BUFFER_LEN];
 
+/** Período de amostragem em microsegundos */
+uint32_t _samplePeriod = 1000UL;
 /** Intervalo de plotagem em microsegundos */
 uint32_t _callbackPeriod = 0;
 /** Última vez que os dados foram plotados (micros) */
@@ -62,6 +80,26 @@ uint32_t _last_plot = 0;
 int _adc_channel = CHANNEL_ADC1;
 /** Modo fallback: leitura direta do ADC se I2S/DMA indisponível ou MAC simulada detectada */
 bool _adc_fallback_mode = false;
+/** Fonte sintética de amostras (NULL = ADC) */
+SampleSource_c *_adc_source = NULL;
+/** Relógio virtual da fonte sintética (us, esp_timer) */
+uint64_t _adc_source_time = 0;
+/** true até o primeiro bloco da fonte sintética, que alinha _adc_source_time ao esp_timer */
+bool _adc_source_sync = false;
+/** Fila que recebe os blocos do pool (NULL = só callback) */
+jQueue_t *_adc_queue = NULL;
+/** Canal gravado nos blocos enviados */
+uint8_t _adc_queue_channel = 0;
+/** Fila de eventos do driver I2S (um item por buffer DMA completo) */
+QueueHandle_t _adc_i2s_queue = NULL;
+/** Aquisições descartadas (sem bloco livre ou fila cheia) */
+uint32_t _adc_dropped = 0;
+/** Relógio de amostragem: instante e número de sequência de cada aquisição */
+jClock_t _adc_clock;
+/** Instante (us, esp_timer) da primeira amostra da última aquisição */
+uint64_t _adc_last_t0 = 0;
+/** Número de sequência da última aquisição */
+uint32_t _adc_last_seq = 0;
 
 /**
  * @brief Detecta se o endereço MAC corresponde ao ambiente simulado Wokwi.
@@ -73,10 +111,6 @@ bool detectWokwiByMac()
     uint8_t mac[6];
     esp_read_mac(mac, ESP_MAC_WIFI_STA);
 
-    // Exibe o MAC detectado para debug
-    Serial.printf("MAC detectado: %02X:%02X:%02X:%02X:%02X:%02X\n",
-                  mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-
     // Verifica se o MAC é 24:0A:C4:00:01:10 (Wokwi padrão)
     return (mac[0] == 0x24 && mac[1] == 0x0A && mac[2] == 0xC4 && mac[3] == 0x00 && mac[4] == 0x01 && mac[5] == 0x10) ||
            (mac[0] == 0x00 && mac[1] == 0x00 && mac[2] == 0x00 && mac[3] == 0x00 && mac[4] == 0x00 && mac[5] == 0x00);
@@ -90,25 +124,25 @@ bool detectWokwiByMac()
  * com leitura direta do ADC no loop.
  *
  * @param channel Canal ADC (do tipo adc1_channel_t) a ser utilizado (ex: ADC1_CHANNEL_0, ADC1_CHANNEL_3, etc.).
- * @param samplePeriod Taxa de amostragem em microsegundos do DMA (padrão: 1000 us).
+ * @param samplePeriod Taxa de amostragem em microsegundos do DMA (padrão: IIKitCfg.adcSamplePeriod, 1000 us).
  * @param callbackFunc Função de callback que será invocada com os dados adquiridos do DMA até aquele instante.
- * @param callbackPeriod Intervalo de execução do callback em microsegundos (padrão: 100000 us).
+ * @param callbackPeriod Intervalo de execução do callback em microsegundos (padrão: IIKitCfg.adcCallbackPeriod, 100000 us).
  * @param width_bit Largura dos bits para conversão ADC (padrão ADC_WIDTH_BIT_12).
  */
 void adcDmaSetup(
     adc1_channel_t channel,
-    uint32_t samplePeriod = 1000UL,
+    uint32_t samplePeriod = IIKitCfg.adcSamplePeriod,
     CallbackADC callbackFunc = nullptr,
-    uint32_t callbackPeriod = 100000UL,
+    uint32_t callbackPeriod = IIKitCfg.adcCallbackPeriod,
     adc_bits_width_t width_bit = ADC_WIDTH_BIT_12)
 {
     _callbackFunc = callbackFunc;
     _callbackPeriod = callbackPeriod;
+    _samplePeriod = samplePeriod;
     _adc_channel = channel;
     _adc_fallback_mode = false; // Tenta modo DMA/I2S
-
-    Serial.begin(115200);  // Garante que Serial está iniciado
-    delay(100);  // Pequeno delay para estabilizar o sistema antes de ler MAC
+    // Atraso de leitura acima do buffer DMA inteiro significa amostras sobrescritas.
+    jclockInit(&_adc_clock, samplePeriod, DMA_BUFFERS * BUFFER_LEN * samplePeriod);
 
     // Detecta ambiente Wokwi pelo MAC address
     if (detectWokwiByMac()) {
@@ -136,7 +170,7 @@ void adcDmaSetup(
         .fixed_mclk = 0,
         .mclk_multiple = I2S_MCLK_MULTIPLE_256};
 
-    esp_err_t res = i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL);
+    esp_err_t res = i2s_driver_install(I2S_NUM_0, &i2s_config, DMA_BUFFERS, &_adc_i2s_queue);
 
     if (res == ESP_OK) {
         i2s_set_adc_mode(ADC_UNIT_1, channel);
@@ -148,34 +182,180 @@ void adcDmaSetup(
     }
 }
 
+/**
+ * @brief Substitui o ADC por uma fonte de amostras (ou volta ao ADC com NULL).
+ *
+ * O relógio virtual da fonte é reiniciado no instante atual do esp_timer e realinhado no
+ * primeiro bloco, cuja última amostra corresponde ao instante da leitura.
+ * @param source Fonte de amostras, por exemplo um SignalSource_c.
+ */
+void adcDmaSetSource(SampleSource_c *source)
+{
+    _adc_source = source;
+    _adc_source_time = esp_timer_get_time();
+    _adc_source_sync = true;
+    jclockInit(&_adc_clock, _samplePeriod);
+}
+
+/**
+ * @brief Passa a entregar cada aquisição em um bloco do pool (jpool.h) pela fila indicada.
+ *
+ * As amostras são lidas direto no bloco, que é enviado à fila; o consumidor deve devolvê-lo
+ * com jpoolRelease(). Sem bloco livre ou com a fila cheia a aquisição é descartada e
+ * contada em adcDmaDropped(). Pode ser usado junto com o callback, que recebe o mesmo buffer.
+ *
+ * @param queue Fila que recebe ponteiros jBlock_t* (NULL desliga).
+ * @param channel Valor gravado em jBlock_t::channel.
+ */
+void adcDmaAttachQueue(jQueue_t *queue, uint8_t channel = 0)
+{
+    _adc_queue = queue;
+    _adc_queue_channel = channel;
+}
+
+/**
+ * @brief Retorna o número de aquisições descartadas por falta de bloco ou fila cheia.
+ */
+uint32_t adcDmaDropped()
+{
+    return _adc_dropped;
+}
+
 /**
  * @brief Loop de aquisição e callback.
  *
  * Esta função deve ser chamada periodicamente no loop principal. Ela lê os dados do ADC
- * via I2S utilizando DMA e, se o intervalo de plotagem tiver decorrido, invoca o callback com os dados.
+ * via I2S utilizando DMA e, se o intervalo de plotagem tiver decorrido, invoca o callback com os dados
+ * e/ou envia o bloco à fila de adcDmaAttachQueue().
  * Caso o modo fallback esteja ativo (I2S não disponível ou MAC simulada detectada), realiza leituras diretas do ADC para simular um buffer.
  */
 void adcDmaLoop()
 {
-    if (_callbackFunc != nullptr)
-    {
-        if (micros() - _last_plot >= _callbackPeriod)
-        {
-            if (!_adc_fallback_mode) {
-                size_t bytes_read;
-                esp_err_t err = i2s_read(I2S_NUM_0, dma_buffer, sizeof(dma_buffer), &bytes_read, 0);
-                if (err == ESP_OK) {
-                    _callbackFunc(dma_buffer, (uint16_t)(bytes_read / sizeof(int16_t)));
-                }
-            } else {
-                for (int i = 0; i < BUFFER_LEN; ++i) {
-                    fallback_buffer[i] = adc1_get_raw((adc1_channel_t)_adc_channel);
-                }
-                _callbackFunc(fallback_buffer, BUFFER_LEN);
-            }
-            _last_plot = micros();
+    if (_callbackFunc == nullptr && _adc_queue == NULL) return;
+    if (micros() - _last_plot < _callbackPeriod) return;
+    JPROF_SCOPE("adcDma");
+
+    jBlock_t *block = NULL;
+    const bool direct = _adc_fallback_mode && _adc_source == NULL;
+    int16_t *buffer = direct ? fallback_buffer : dma_buffer;
+    size_t capacity = direct ? BUFFER_LEN : DMA_BUFFERS * BUFFER_LEN;
+    if (_adc_queue != NULL) {
+        block = jpoolAlloc();
+        if (block != NULL) {
+            buffer = block->data;
+            capacity = JPOOL_BLOCK_LEN;
+        } else {
+            _adc_dropped++; // Sem bloco: lê mesmo assim para esvaziar o DMA.
+        }
+    }
+
+    bool ok = true;
+    size_t count = 0;
+    uint64_t t0 = 0;
+    uint32_t seq = 0;
+    if (_adc_source != NULL) {
+        count = _callbackPeriod / _samplePeriod;
+        if (count == 0) count = 1;
+        if (count > capacity) count = capacity;
+        if (_adc_source_sync) {
+            const uint64_t now = esp_timer_get_time();
+            const uint64_t span = (uint64_t)(count - 1) * _samplePeriod;
+            _adc_source_time = (now > span) ? now - span : 0;
+            _adc_source_sync = false;
+        }
+        _adc_source->read(buffer, count, _adc_source_time, _samplePeriod);
+        // Relógio virtual: a "leitura" acontece exatamente na última amostra.
+        t0 = jclockStamp(&_adc_clock, count, _adc_source_time + (uint64_t)(count - 1) * _samplePeriod, &seq);
+        _adc_source_time += (uint64_t)count * _samplePeriod;
+    } else if (!_adc_fallback_mode) {
+        size_t bytes_read;
+        ok = i2s_read(I2S_NUM_0, buffer, capacity * sizeof(int16_t), &bytes_read, 0) == ESP_OK;
+        count = ok ? bytes_read / sizeof(int16_t) : 0;
+        if (count > 0) t0 = jclockStamp(&_adc_clock, count, esp_timer_get_time(), &seq);
+    } else {
+        // Leitura direta em rajada: as amostras não seguem o período, só a sequência vale.
+        count = (capacity < BUFFER_LEN) ? capacity : BUFFER_LEN;
+        t0 = esp_timer_get_time();
+        seq = _adc_clock.seq++;
+        for (size_t i = 0; i < count; ++i) {
+            buffer[i] = adc1_get_raw((adc1_channel_t)_adc_channel);
+        }
+    }
+    if (count > 0) {
+        _adc_last_t0 = t0;
+        _adc_last_seq = seq;
+    }
+
+    if (ok && _callbackFunc != nullptr) _callbackFunc(buffer, count);
+    if (block != NULL) {
+        block->count = count;
+        block->channel = _adc_queue_channel;
+        block->period = _samplePeriod;
+        block->seq = seq;
+        block->t0 = t0;
+        if (count == 0) {
+            jpoolRelease(block);
+        } else if (!jQueueSendFromISR(_adc_queue, block)) {
+            _adc_dropped++;
+            jpoolRelease(block);
         }
     }
+    _last_plot = micros();
+}
+
+/**
+ * @brief Retorna o instante (us, esp_timer) da primeira amostra do último buffer entregue.
+ *
+ * Para uso dentro do CallbackADC, que recebe só as amostras.
+ */
+uint64_t adcDmaLastTime()
+{
+    return _adc_last_t0;
+}
+
+/**
+ * @brief Retorna o número de sequência do último buffer entregue (lacunas = aquisições perdidas).
+ */
+uint32_t adcDmaLastSeq()
+{
+    return _adc_last_seq;
+}
+
+/**
+ * @brief Retorna o período de amostragem estimado pelo relógio de amostragem, em nanossegundos.
+ */
+uint32_t adcDmaPeriodNs()
+{
+    return jclockPeriodNs(&_adc_clock);
+}
+
+/**
+ * @brief Retorna o tempo (us) até adcDmaLoop() ter uma entrega a fazer (UINT32_MAX se inativo).
+ */
+uint32_t adcDmaNextDue()
+{
+    if (_callbackFunc == nullptr && _adc_queue == NULL) return UINT32_MAX;
+    const uint32_t elapsed = micros() - _last_plot;
+    return (elapsed >= _callbackPeriod) ? 0 : _callbackPeriod - elapsed;
+}
+
+/**
+ * @brief Registra a aquisição no loop de eventos (jevent.h).
+ *
+ * A fila de eventos do I2S passa a acordar o loop com bits a cada buffer DMA completo e o
+ * prazo do próximo callback entra no cálculo da espera. adcDmaLoop() é chamada nos dois casos.
+ * Deve ser chamada após jeventBegin() e adcDmaSetup().
+ * @param bits Bits sinalizados pelos eventos do I2S (padrão: JEVENT_ADC).
+ * @return true se o prazo e o handler foram registrados.
+ */
+bool adcDmaAttachEvents(uint32_t bits = JEVENT_ADC)
+{
+    if (_adc_i2s_queue != NULL) {
+        xQueueReset(_adc_i2s_queue); // O queue set só aceita filas vazias.
+        jeventAddQueue(_adc_i2s_queue, bits, sizeof(i2s_event_t));
+    }
+    return jeventAddDeadline(adcDmaNextDue) &&
+           jeventAttach(bits | JEVENT_TIMEOUT, [](uint32_t) { adcDmaLoop(); });
 }
 
 #endif // ADCDMAESP_H
\ No newline at end of file
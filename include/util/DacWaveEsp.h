@@ -0,0 +1,290 @@
+/**
+ * @file DacWaveEsp.h
+ * @brief Gerador de formas de onda para os DACs internos do ESP32 via I2S com DMA.
+ *
+ * As amostras são entregues ao DAC pelo periférico I2S0 no modo DAC built-in, de forma que
+ * o instante de cada conversão é definido pelo relógio do I2S e não pelo loop. Cada canal
+ * usa um sintetizador digital direto (DDS): um acumulador de fase de 32 bits percorre uma
+ * tabela de DAC_WAVE_TABLE_LEN amostras, o que dá resolução de frequência de
+ * sampleRate / 2^32 (cerca de 23 uHz a 100 kHz).
+ *
+ * A troca de tabela é feita sem glitch: a nova tabela é escrita no banco reserva e só
+ * passa a ser usada quando o acumulador de fase completa um ciclo. O banco reserva só é
+ * publicado (pending) depois da cópia, e a tarefa confere pending de novo dentro da seção
+ * crítica antes de trocar, então nunca toca uma tabela pela metade. As tabelas devem ser
+ * carregadas por uma única tarefa da aplicação.
+ *
+ * Canais: DAC_WAVE_CH_DAC1 (GPIO25, def_pin_DAC1) e DAC_WAVE_CH_4A20 (GPIO26, def_pin_W4a20_1).
+ *
+ * GPIO26 é também o pino de IIKitmini_c::out4a20, que IIKit.setup() liga ao LEDC pelo GPIO
+ * matrix. Com use4a20, dacWaveSetup() desliga essa rota (e o driver digital do pino) para
+ * que o LEDC não brigue com o DAC, e dacWaveStop() a restaura; enquanto isso as escritas em
+ * out4a20 não chegam ao pino.
+ *
+ * @note O DAC built-in só está disponível no I2S0, o mesmo usado por AdcDmaEsp.h; os dois
+ * módulos não podem ser usados ao mesmo tempo.
+ */
+
+#ifndef DACWAVEESP_H
+#define DACWAVEESP_H
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <soc/gpio_struct.h>
+#include <soc/gpio_sig_map.h>
+
+#define DAC_WAVE_CH_DAC1 0 ///< Canal direito do I2S: DAC1, GPIO25.
+#define DAC_WAVE_CH_4A20 1 ///< Canal esquerdo do I2S: DAC2, GPIO26 (saída 4-20mA).
+#define DAC_WAVE_PIN_4A20 26 ///< Pino do DAC2, compartilhado com o LEDC de IIKitmini_c::out4a20.
+
+// Bits de índice da tabela (padrão: 8, ou seja, 256 amostras)
+#ifndef DAC_WAVE_TABLE_BITS
+#define DAC_WAVE_TABLE_BITS 8
+#endif
+#define DAC_WAVE_TABLE_LEN (1 << DAC_WAVE_TABLE_BITS)
+
+// Número de buffers DMA do DAC (padrão: 4)
+#ifndef DAC_WAVE_DMA_BUFFERS
+#define DAC_WAVE_DMA_BUFFERS 4
+#endif
+
+// Tamanho de cada buffer DMA (em quadros estéreo; padrão: 256)
+#ifndef DAC_WAVE_DMA_LEN
+#define DAC_WAVE_DMA_LEN 256
+#endif
+
+/**
+ * @struct DacWaveChannel_t
+ * @brief Estado do sintetizador de um canal.
+ */
+typedef struct {
+    uint8_t table[2][DAC_WAVE_TABLE_LEN]; ///< Banco ativo e banco reserva.
+    volatile uint8_t active;              ///< Índice do banco ativo.
+    volatile bool pending;                ///< Banco reserva pronto para entrar no próximo ciclo.
+    uint32_t phase;                       ///< Acumulador de fase.
+    volatile uint32_t increment;          ///< Incremento de fase por amostra (0 = parado).
+    bool enabled;                         ///< Canal habilitado em dacWaveSetup().
+} DacWaveChannel_t;
+
+/** Estado dos dois canais */
+DacWaveChannel_t _dacWave[2];
+/** Taxa de amostragem em Hz */
+uint32_t _dacWaveRate = 0;
+/** Tarefa que alimenta o DMA (a própria tarefa zera ao terminar) */
+TaskHandle_t _dacWaveTask = NULL;
+/** false pede à tarefa que termine (dacWaveStop()) */
+volatile bool _dacWaveRun = false;
+/** Protege a troca de bancos entre a tarefa e a aplicação */
+portMUX_TYPE _dacWaveMux = portMUX_INITIALIZER_UNLOCKED;
+/** Sinal do GPIO matrix que saía em GPIO26 antes de dacWaveSetup() (SIG_GPIO_OUT_IDX = nenhum) */
+uint32_t _dacWave4a20Signal = SIG_GPIO_OUT_IDX;
+
+/**
+ * @brief Solta GPIO26 do periférico digital (LEDC de out4a20) antes de o DAC2 assumir o pino.
+ */
+void _dacWaveClaim4a20(void) {
+    _dacWave4a20Signal = GPIO.func_out_sel_cfg[DAC_WAVE_PIN_4A20].func_sel;
+    pinMatrixOutDetach(DAC_WAVE_PIN_4A20, false, false);
+    pinMode(DAC_WAVE_PIN_4A20, INPUT); // Desliga o driver digital do pino.
+}
+
+/**
+ * @brief Devolve GPIO26 ao sinal que ele tinha antes de _dacWaveClaim4a20().
+ */
+void _dacWaveRelease4a20(void) {
+    if (_dacWave4a20Signal == SIG_GPIO_OUT_IDX) return;
+    pinMode(DAC_WAVE_PIN_4A20, OUTPUT);
+    pinMatrixOutAttach(DAC_WAVE_PIN_4A20, _dacWave4a20Signal, false, false);
+    _dacWave4a20Signal = SIG_GPIO_OUT_IDX;
+}
+
+/**
+ * @brief Gera as próximas amostras de um canal e aplica trocas de tabela pendentes.
+ */
+inline uint8_t dacWaveNext(DacWaveChannel_t &ch) {
+    const uint32_t prev = ch.phase;
+    ch.phase += ch.increment;
+    // Fim de ciclo (ou canal parado): ponto seguro para trocar a tabela.
+    if (ch.pending && (ch.phase < prev || ch.increment == 0)) {
+        portENTER_CRITICAL(&_dacWaveMux);
+        if (ch.pending) { // dacWaveTable() pode ter começado outra cópia desde o teste acima.
+            ch.active ^= 1;
+            ch.pending = false;
+        }
+        portEXIT_CRITICAL(&_dacWaveMux);
+    }
+    return ch.table[ch.active][ch.phase >> (32 - DAC_WAVE_TABLE_BITS)];
+}
+
+/**
+ * @brief Tarefa que mantém o DMA do I2S sempre abastecido.
+ *
+ * i2s_write() bloqueia até haver espaço, então a tarefa só ocupa a CPU para calcular amostras.
+ * Termina sozinha quando _dacWaveRun é zerado, fora do i2s_write().
+ */
+void dacWaveTask(void *arg) {
+    (void)arg;
+    static uint32_t frames[DAC_WAVE_DMA_LEN];
+    while (_dacWaveRun) {
+        for (size_t i = 0; i < DAC_WAVE_DMA_LEN; i++) {
+            // O DAC usa o byte mais significativo de cada meia-palavra de 16 bits.
+            const uint32_t right = _dacWave[DAC_WAVE_CH_DAC1].enabled ? dacWaveNext(_dacWave[DAC_WAVE_CH_DAC1]) : 0;
+            const uint32_t left = _dacWave[DAC_WAVE_CH_4A20].enabled ? dacWaveNext(_dacWave[DAC_WAVE_CH_4A20]) : 0;
+            frames[i] = (right << 24) | (left << 8);
+        }
+        size_t written;
+        i2s_write(I2S_NUM_0, frames, sizeof(frames), &written, pdMS_TO_TICKS(100));
+    }
+    _dacWaveTask = NULL; // Avisa dacWaveStop() que o I2S está livre.
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Configura o I2S0 no modo DAC built-in e inicia a geração.
+ *
+ * Os canais começam parados (nível médio, 128) até que uma tabela e uma frequência sejam definidas.
+ *
+ * @param useDac1 Habilita o canal DAC1 (GPIO25).
+ * @param use4a20 Habilita o canal DAC2 (GPIO26, saída 4-20mA). O LEDC de out4a20 é
+ * desligado do pino até dacWaveStop().
+ * @param sampleRate Taxa de amostragem em Hz (padrão: 100000 Hz).
+ * @return true se o I2S foi configurado com sucesso.
+ */
+bool dacWaveSetup(bool useDac1 = true, bool use4a20 = false, uint32_t sampleRate = 100000UL) {
+    memset(_dacWave, 0, sizeof(_dacWave));
+    memset(_dacWave[0].table, 128, sizeof(_dacWave[0].table));
+    memset(_dacWave[1].table, 128, sizeof(_dacWave[1].table));
+    _dacWave[DAC_WAVE_CH_DAC1].enabled = useDac1;
+    _dacWave[DAC_WAVE_CH_4A20].enabled = use4a20;
+    _dacWaveRate = sampleRate;
+    if (use4a20) _dacWaveClaim4a20();
+
+    i2s_config_t i2s_config = {
+        .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN),
+        .sample_rate = sampleRate,
+        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+        .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
+        .communication_format = I2S_COMM_FORMAT_STAND_MSB,
+        .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+        .dma_buf_count = DAC_WAVE_DMA_BUFFERS,
+        .dma_buf_len = DAC_WAVE_DMA_LEN,
+        .use_apll = false,
+        .tx_desc_auto_clear = true,
+        .fixed_mclk = 0,
+        .mclk_multiple = I2S_MCLK_MULTIPLE_256};
+
+    if (i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL) != ESP_OK) {
+        Serial.println("WARN: I2S DAC não disponível.");
+        _dacWaveRelease4a20();
+        return false;
+    }
+    i2s_set_dac_mode((i2s_dac_mode_t)((useDac1 ? I2S_DAC_CHANNEL_RIGHT_EN : 0) | (use4a20 ? I2S_DAC_CHANNEL_LEFT_EN : 0)));
+    _dacWaveRun = true;
+    if (xTaskCreatePinnedToCore(dacWaveTask, "dacWave", 2048, NULL, 5, &_dacWaveTask, tskNO_AFFINITY) != pdPASS) {
+        _dacWaveRun = false;
+        _dacWaveTask = NULL;
+        i2s_driver_uninstall(I2S_NUM_0);
+        _dacWaveRelease4a20();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Para a geração e libera o I2S0.
+ *
+ * Pede à tarefa que termine e espera por ela antes de desinstalar o driver, em vez de
+ * apagá-la no meio de um i2s_write(). GPIO26 volta ao LEDC, se estava com ele antes.
+ */
+void dacWaveStop(void) {
+    _dacWaveRun = false;
+    while (_dacWaveTask != NULL) vTaskDelay(1);
+    i2s_set_dac_mode(I2S_DAC_CHANNEL_DISABLE);
+    i2s_driver_uninstall(I2S_NUM_0);
+    _dacWaveRelease4a20();
+}
+
+/**
+ * @brief Define a frequência de saída de um canal.
+ *
+ * @param channel DAC_WAVE_CH_DAC1 ou DAC_WAVE_CH_4A20.
+ * @param hz Frequência em Hz (0 congela a saída no valor atual).
+ */
+void dacWaveFrequency(uint8_t channel, double hz) {
+    if (channel > 1 || _dacWaveRate == 0) return;
+    _dacWave[channel].increment = (uint32_t)(hz * 4294967296.0 / _dacWaveRate);
+}
+
+/**
+ * @brief Carrega uma tabela arbitrária de DAC_WAVE_TABLE_LEN amostras (0 a 255).
+ *
+ * A tabela é copiada para o banco reserva e entra em uso no início do próximo ciclo.
+ * Não deve ser chamada por mais de uma tarefa ao mesmo tempo.
+ * @param channel DAC_WAVE_CH_DAC1 ou DAC_WAVE_CH_4A20.
+ * @param table Amostras de um período da forma de onda.
+ */
+void dacWaveTable(uint8_t channel, const uint8_t *table) {
+    if (channel > 1) return;
+    DacWaveChannel_t &ch = _dacWave[channel];
+    // Retira a publicação anterior: a partir daqui a tarefa não troca mais de banco e o
+    // reserva pode ser sobrescrito.
+    portENTER_CRITICAL(&_dacWaveMux);
+    ch.pending = false;
+    const uint8_t spare = ch.active ^ 1;
+    portEXIT_CRITICAL(&_dacWaveMux);
+    memcpy(ch.table[spare], table, DAC_WAVE_TABLE_LEN);
+    portENTER_CRITICAL(&_dacWaveMux);
+    ch.pending = true; // Publica só depois da cópia completa.
+    portEXIT_CRITICAL(&_dacWaveMux);
+}
+
+/**
+ * @brief Carrega uma senoide.
+ * @param channel DAC_WAVE_CH_DAC1 ou DAC_WAVE_CH_4A20.
+ * @param amplitude Amplitude de pico (0 a 127).
+ * @param offset Nível médio (0 a 255).
+ */
+void dacWaveSine(uint8_t channel, uint8_t amplitude = 127, uint8_t offset = 128) {
+    uint8_t table[DAC_WAVE_TABLE_LEN];
+    for (int i = 0; i < DAC_WAVE_TABLE_LEN; i++) {
+        const int v = offset + (int)lroundf(amplitude * sinf(2.0f * (float)M_PI * i / DAC_WAVE_TABLE_LEN));
+        table[i] = (uint8_t)constrain(v, 0, 255);
+    }
+    dacWaveTable(channel, table);
+}
+
+/**
+ * @brief Carrega uma rampa (dente de serra) crescente.
+ * @param channel DAC_WAVE_CH_DAC1 ou DAC_WAVE_CH_4A20.
+ * @param amplitude Amplitude de pico (0 a 127).
+ * @param offset Nível médio (0 a 255).
+ */
+void dacWaveRamp(uint8_t channel, uint8_t amplitude = 127, uint8_t offset = 128) {
+    uint8_t table[DAC_WAVE_TABLE_LEN];
+    for (int i = 0; i < DAC_WAVE_TABLE_LEN; i++) {
+        const int v = offset - amplitude + (2 * amplitude * i) / (DAC_WAVE_TABLE_LEN - 1);
+        table[i] = (uint8_t)constrain(v, 0, 255);
+    }
+    dacWaveTable(channel, table);
+}
+
+/**
+ * @brief Carrega uma onda quadrada.
+ * @param channel DAC_WAVE_CH_DAC1 ou DAC_WAVE_CH_4A20.
+ * @param amplitude Amplitude de pico (0 a 127).
+ * @param offset Nível médio (0 a 255).
+ * @param duty Fração do período em nível alto, em 1/256 (padrão: 128 = 50%).
+ */
+void dacWaveSquare(uint8_t channel, uint8_t amplitude = 127, uint8_t offset = 128, uint8_t duty = 128) {
+    uint8_t table[DAC_WAVE_TABLE_LEN];
+    const int high = constrain(offset + amplitude, 0, 255);
+    const int low = constrain(offset - amplitude, 0, 255);
+    for (int i = 0; i < DAC_WAVE_TABLE_LEN; i++) {
+        table[i] = (uint8_t)(((i << 8) >> DAC_WAVE_TABLE_BITS) < duty ? high : low);
+    }
+    dacWaveTable(channel, table);
+}
+
+#endif // DACWAVEESP_H
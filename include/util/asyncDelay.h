@@ -1,3 +1,6 @@
+#ifndef __ASYNC_DELAY_H
+#define __ASYNC_DELAY_H
+
 #include <Arduino.h>
 #include <stdint.h>
 
@@ -39,6 +42,13 @@ public:
      * @brief Ajusta o tempo de expiração para o próximo intervalo, mantendo o mesmo valor de _interval.
      */
     void repeat(void);
+
+    /**
+     * @brief Retorna o tempo restante até a expiração, em milissegundos (0 se já expirou).
+     *
+     * Não altera o estado; usado por jsleep.h para calcular o próximo despertar.
+     */
+    uint32_t remaining(void) const;
 };
 
 inline AsyncDelay_c::AsyncDelay_c(const uint32_t interval) {
@@ -65,4 +75,11 @@ inline bool AsyncDelay_c::isExpired(void) {
 inline void AsyncDelay_c::repeat(void) {
     // Ao simplesmente somar _interval, criamos um novo ponto de expiração no futuro.
     _expires += _interval;
-}
\ No newline at end of file
+}
+
+inline uint32_t AsyncDelay_c::remaining(void) const {
+    const int32_t left = (int32_t)(_expires - millis());
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+#endif
@@ -2,6 +2,15 @@
 #define DIGITAL_IN_DEBOUNCE_H
 
 #include "Arduino.h"
+#include <esp_timer.h>
+#include "iikitConfig.h"
+
+/**
+ * @brief Valor de debounceDelay que segue o parâmetro debounceMs da configuração (iikitConfig.h).
+ *
+ * O valor é lido a cada update(), então "cfg debounceMs ..." vale na hora, sem regravar o firmware.
+ */
+#define DEBOUNCE_CFG ((unsigned long)-1)
 
 /**
  * @brief Classe para leitura digital com debounce utilizando callback.
@@ -18,22 +27,22 @@ public:
   /**
    * @brief Construtor da classe.
    * @param pin Número do pino a ser lido.
-   * @param debounceDelay Tempo de debounce em milissegundos (padrão: 50ms).
+   * @param debounceDelay Tempo de debounce em milissegundos (padrão: DEBOUNCE_CFG, IIKitCfg.debounceMs).
    * @param callback Função callback a ser chamada quando houver mudança de estado.
    * @param mode Modo do pino (INPUT, INPUT_PULLUP, etc).*
    */
-  DigitalINDebounce(uint8_t pin = 0, unsigned long debounceDelay = 50, CallbackFunc callback = nullptr, uint8_t mode = INPUT_PULLDOWN)
+  DigitalINDebounce(uint8_t pin = 0, unsigned long debounceDelay = DEBOUNCE_CFG, CallbackFunc callback = nullptr, uint8_t mode = INPUT_PULLDOWN)
   {
     setup(pin, debounceDelay, callback, mode);
   }
   /**
    * @brief Inicializa o pino caso o construtor usado foi DigitalDebounce().
    * @param pin Número do pino a ser lido.
-   * @param debounceDelay Tempo de debounce em milissegundos (padrão: 50ms).
+   * @param debounceDelay Tempo de debounce em milissegundos (padrão: DEBOUNCE_CFG, IIKitCfg.debounceMs).
    * @param callback Função callback a ser chamada quando houver mudança de estado.
    * @param mode Modo do pino (INPUT, INPUT_PULLUP, etc).*
    */
-  void setup(uint8_t pin, unsigned long debounceDelay = 50, CallbackFunc callback = nullptr, uint8_t mode = INPUT_PULLDOWN)
+  void setup(uint8_t pin, unsigned long debounceDelay = DEBOUNCE_CFG, CallbackFunc callback = nullptr, uint8_t mode = INPUT_PULLDOWN)
   {
     _pin = pin;
     _debounceDelay = debounceDelay;
@@ -58,15 +67,17 @@ public:
     if (reading != _currentState)
     {
       _lastDebounceTime = millis();
+      _edgeTime = esp_timer_get_time();
       _currentState = reading;
     }
 
     // Se o tempo decorrido for maior ou igual ao debounceDelay, confirma o novo estado
-    if ((millis() - _lastDebounceTime) >= _debounceDelay)
+    if ((millis() - _lastDebounceTime) >= debounceDelay())
     {
       if (_stableState != _currentState)
       {
         _stableState = _currentState;
+        _stableTime = _edgeTime;
         // Chama a callback se ela estiver definida
         if (_callback != nullptr)
         {
@@ -83,6 +94,45 @@ public:
   {
     return _stableState;
   }
+  /**
+   * @brief Retorna o instante (us, esp_timer) da borda que levou ao estado estável atual.
+   *
+   * É o instante em que a borda foi vista, e não o da confirmação após o debounce, na mesma
+   * base de tempo dos blocos da aquisição (jBlock_t::t0).
+   */
+  uint64_t edgeTime()
+  {
+    return _stableTime;
+  }
+  /**
+   * @brief Retorna o tempo (em microssegundos) até update() poder confirmar uma mudança pendente.
+   *
+   * Com o pino ligado a jeventAttachPin(), o loop de eventos só precisa acordar na borda
+   * e neste prazo.
+   * @return 0 se a confirmação já venceu, UINT32_MAX se não houver mudança pendente.
+   */
+  uint32_t nextDue()
+  {
+    if (_stableState == _currentState) return UINT32_MAX;
+    const unsigned long elapsed = millis() - _lastDebounceTime;
+    const unsigned long wait = debounceDelay();
+    return (elapsed >= wait) ? 0 : (uint32_t)(wait - elapsed) * 1000UL;
+  }
+  /**
+   * @brief Retorna o tempo de debounce em uso, em milissegundos.
+   */
+  unsigned long debounceDelay()
+  {
+    return (_debounceDelay == DEBOUNCE_CFG) ? IIKitCfg.debounceMs : _debounceDelay;
+  }
+  /**
+   * @brief Altera o tempo de debounce.
+   * @param debounceDelay Tempo de debounce em milissegundos (DEBOUNCE_CFG segue a configuração).
+   */
+  void setDebounceDelay(unsigned long debounceDelay)
+  {
+    _debounceDelay = debounceDelay;
+  }
   /**
    * @brief Define ou altera a função callback.
    * @param callback Função callback que recebe o novo estado do pino.
@@ -98,6 +148,8 @@ private:
   bool _currentState;              // Última leitura instantânea do pino
   bool _stableState;               // Estado estável após debounce
   unsigned long _lastDebounceTime; // Último instante de mudança detectada
+  uint64_t _edgeTime = 0;          // Instante (esp_timer) da última borda lida
+  uint64_t _stableTime = 0;        // Instante (esp_timer) da borda do estado estável
   CallbackFunc _callback;          // Função callback para notificar mudança de estado
 };
 
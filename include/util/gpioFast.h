@@ -0,0 +1,43 @@
+/**
+ * @file gpioFast.h
+ * @brief Acesso direto aos registradores de GPIO com o pino definido em tempo de compilação.
+ *
+ * Com o pino como parâmetro de template, o registrador (banco 0-31 ou 32-39) e a máscara
+ * são resolvidos pelo compilador e cada escrita vira um único store em GPIO.out_w1ts /
+ * out_w1tc, sem a consulta de tabela de pinos do digitalWrite(). O pino deve ter sido
+ * configurado antes com pinMode().
+ */
+
+#ifndef __GPIO_FAST_H
+#define __GPIO_FAST_H
+
+#include <Arduino.h>
+#include <soc/gpio_struct.h>
+
+/**
+ * @brief Escreve o nível de uma saída digital.
+ * @tparam Pin Pino de saída (0 a 33).
+ */
+template <uint8_t Pin>
+inline void IRAM_ATTR gpioWrite(bool level) {
+    static_assert(Pin < 34, "GPIO34 a GPIO39 sao somente entrada");
+    if (Pin < 32) {
+        if (level) GPIO.out_w1ts = 1UL << (Pin & 31);
+        else GPIO.out_w1tc = 1UL << (Pin & 31);
+    } else {
+        if (level) GPIO.out1_w1ts.val = 1UL << (Pin & 31);
+        else GPIO.out1_w1tc.val = 1UL << (Pin & 31);
+    }
+}
+
+/**
+ * @brief Lê o nível de um pino.
+ * @tparam Pin Pino (0 a 39).
+ */
+template <uint8_t Pin>
+inline bool IRAM_ATTR gpioRead(void) {
+    static_assert(Pin < 40, "pino inexistente");
+    return Pin < 32 ? (GPIO.in >> (Pin & 31)) & 1 : (GPIO.in1.val >> (Pin & 31)) & 1;
+}
+
+#endif
@@ -0,0 +1,337 @@
+/**
+ * @file hartPoll.h
+ * @brief Escalonador de polling HART multidrop com cache local das variáveis dinâmicas.
+ *
+ * A 1200 baud cada transação HART leva centenas de milissegundos. Este módulo mantém
+ * uma cópia local, com carimbo de tempo, das variáveis dinâmicas (comando 3) de cada
+ * dispositivo do barramento e a atualiza em segundo plano, sem bloquear o loop:
+ * - a cada chamada de update() os bytes recebidos são entregues ao HartFrameParser;
+ * - quando o barramento está livre, é escolhido o dispositivo mais atrasado em relação
+ *   ao seu período de atualização (maior "staleness") e uma única requisição é enviada;
+ * - frames de burst (BACK) recebidos atualizam o cache sem nenhuma requisição; um
+ *   dispositivo em burst mode só é interrogado se ficar HART_BURST_GRACE períodos sem
+ *   enviar frames (burst interrompido).
+ */
+
+#ifndef HART_POLL_H
+#define HART_POLL_H
+
+#include <Arduino.h>
+#include "hartSerial.h"
+
+#ifndef HART_MAX_DEVICES
+/**
+ * @brief Número máximo de dispositivos HART gerenciados pelo escalonador.
+ */
+#define HART_MAX_DEVICES 4
+#endif
+
+#ifndef HART_RESPONSE_TIMEOUT
+/**
+ * @brief Tempo máximo (ms) de espera por uma resposta, incluindo a transmissão a 1200 baud.
+ */
+#define HART_RESPONSE_TIMEOUT 700
+#endif
+
+#ifndef HART_MAX_RETRIES
+/**
+ * @brief Falhas consecutivas após as quais o dispositivo volta a ser identificado (comando 0).
+ */
+#define HART_MAX_RETRIES 3
+#endif
+
+#ifndef HART_BURST_GRACE
+/**
+ * @brief Períodos sem frames após os quais um dispositivo em burst mode volta a ser interrogado.
+ */
+#define HART_BURST_GRACE 2
+#endif
+
+/**
+ * @struct HartDynVars_t
+ * @brief Cópia local das variáveis dinâmicas de um dispositivo (resposta ao comando 3).
+ */
+typedef struct {
+    float current;        ///< Corrente do loop em mA.
+    float pv;             ///< Variável primária.
+    float sv;             ///< Variável secundária.
+    float tv;             ///< Variável terciária.
+    float qv;             ///< Variável quaternária.
+    uint8_t units[4];     ///< Códigos de unidade HART de PV, SV, TV e QV.
+    uint8_t nVars;        ///< Quantidade de variáveis presentes na última resposta (0 a 4).
+    uint8_t status;       ///< Byte de status do dispositivo da última resposta.
+    uint32_t timestamp;   ///< Instante (millis) da última atualização.
+    bool valid;           ///< true após a primeira atualização bem-sucedida.
+} HartDynVars_t;
+
+/**
+ * @struct HartDevice_t
+ * @brief Estado de um dispositivo gerenciado pelo escalonador.
+ */
+typedef struct {
+    uint8_t pollAddr;       ///< Endereço de polling (0 a 63).
+    uint8_t longAddr[5];    ///< Endereço longo obtido pelo comando 0.
+    bool identified;        ///< true se o endereço longo já é conhecido.
+    bool burst;             ///< true se o último frame do dispositivo indicou burst mode.
+    uint8_t failures;       ///< Falhas consecutivas de comunicação.
+    uint32_t lastTry;       ///< Instante (millis) da última requisição enviada.
+    uint32_t period;        ///< Idade máxima desejada (ms) para as variáveis em cache.
+    HartDynVars_t vars;     ///< Variáveis dinâmicas em cache.
+} HartDevice_t;
+
+/**
+ * @class HartPoll_c
+ * @brief Escalonador não bloqueante de requisições HART para vários dispositivos.
+ */
+class HartPoll_c {
+public:
+    /**
+     * @brief Inicializa a UART do modem HART (1200 8O1).
+     * @param rx Pino RX do modem (padrão 16).
+     * @param tx Pino TX do modem (padrão 17).
+     */
+    void begin(int8_t rx = 16, int8_t tx = 17) {
+        _serial.begin(1200, SERIAL_8O1, rx, tx);
+        _parser.reset();
+        _waiting = -1;
+    }
+
+    /**
+     * @brief Registra um dispositivo do barramento.
+     * @param pollAddr Endereço de polling do dispositivo.
+     * @param period Idade máxima desejada (ms) para o cache deste dispositivo.
+     * @return Índice (handle) do dispositivo, ou -1 se a tabela estiver cheia.
+     */
+    int8_t addDevice(uint8_t pollAddr, uint32_t period = 1000) {
+        if (_count >= HART_MAX_DEVICES) return -1;
+        HartDevice_t &dev = _devs[_count];
+        memset(&dev, 0, sizeof(dev));
+        dev.pollAddr = pollAddr;
+        dev.period = period;
+        return _count++;
+    }
+
+    /**
+     * @brief Processa bytes recebidos e, se o barramento estiver livre, envia a próxima requisição.
+     *
+     * Deve ser chamada periodicamente no loop principal. Nunca bloqueia.
+     */
+    void update() {
+        while (_serial.available()) {
+            if (_parser.parse((uint8_t)_serial.read())) {
+                handleFrame(_parser.frame());
+            }
+        }
+        const uint32_t now = millis();
+        if (_waiting >= 0) {
+            if (now - _sentAt < HART_RESPONSE_TIMEOUT) return;
+            fail(_devs[_waiting]);
+            _waiting = -1;
+        }
+        const int8_t next = nextDevice(now);
+        if (next >= 0) request(next, now);
+    }
+
+    /**
+     * @brief Retorna o dispositivo de índice handle (ou NULL se inválido).
+     */
+    const HartDevice_t *device(int8_t handle) const {
+        return (handle >= 0 && handle < _count) ? &_devs[handle] : NULL;
+    }
+
+    /**
+     * @brief Retorna as variáveis dinâmicas em cache do dispositivo (sem acessar o barramento).
+     */
+    const HartDynVars_t *vars(int8_t handle) const {
+        return (handle >= 0 && handle < _count) ? &_devs[handle].vars : NULL;
+    }
+
+    /**
+     * @brief Retorna a variável primária em cache, ou NAN se ainda não foi lida.
+     */
+    float pv(int8_t handle) const {
+        const HartDynVars_t *v = vars(handle);
+        return (v != NULL && v->valid) ? v->pv : NAN;
+    }
+
+    /**
+     * @brief Retorna a idade (ms) do cache do dispositivo, ou UINT32_MAX se ainda não foi lido.
+     */
+    uint32_t age(int8_t handle) const {
+        const HartDynVars_t *v = vars(handle);
+        return (v != NULL && v->valid) ? millis() - v->timestamp : UINT32_MAX;
+    }
+
+    /**
+     * @brief Retorna o tempo (us) até update() ter trabalho por tempo: fim do timeout da
+     * resposta ou próxima requisição vencida. Bytes recebidos devem acordar o loop pelo
+     * onReceive() da serial.
+     */
+    uint32_t nextDue() const {
+        const uint32_t now = millis();
+        if (_waiting >= 0) {
+            const uint32_t elapsed = now - _sentAt;
+            return (elapsed >= HART_RESPONSE_TIMEOUT) ? 0 : (HART_RESPONSE_TIMEOUT - elapsed) * 1000UL;
+        }
+        uint32_t next = UINT32_MAX;
+        for (int8_t i = 0; i < _count; i++) {
+            const HartDevice_t &dev = _devs[i];
+            uint32_t since;
+            if (!dev.identified) {
+                if (dev.lastTry == 0) return 0;
+                since = now - dev.lastTry;
+            } else {
+                if (!dev.vars.valid) return 0;
+                since = now - dev.vars.timestamp;
+            }
+            const uint32_t due = dueAfter(dev);
+            if (since >= due) return 0;
+            const uint32_t left = due - since; // ms; períodos longos não cabem em us de 32 bits.
+            const uint32_t remaining = (left < UINT32_MAX / 1000UL) ? left * 1000UL : UINT32_MAX;
+            if (remaining < next) next = remaining;
+        }
+        return next;
+    }
+
+    /**
+     * @brief Retorna o número de dispositivos registrados.
+     */
+    uint8_t count() const { return _count; }
+
+private:
+    /**
+     * @brief Idade (ms) do cache a partir da qual o dispositivo identificado é interrogado.
+     *
+     * Em burst mode os frames do próprio dispositivo renovam o cache: a requisição só sai
+     * se eles pararem por HART_BURST_GRACE períodos.
+     */
+    static uint32_t dueAfter(const HartDevice_t &dev) {
+        if (!dev.burst) return dev.period;
+        return (dev.period < UINT32_MAX / HART_BURST_GRACE) ? dev.period * HART_BURST_GRACE : UINT32_MAX;
+    }
+
+    /**
+     * @brief Escolhe o dispositivo mais atrasado em relação ao seu período.
+     *
+     * Dispositivos ainda não identificados têm prioridade (no máximo uma tentativa por
+     * período); os demais são ordenados pela diferença entre a idade do cache e o período
+     * (dueAfter(), que considera o burst mode).
+     * @return Índice do dispositivo ou -1 se nenhum estiver vencido.
+     */
+    int8_t nextDevice(uint32_t now) {
+        int8_t best = -1;
+        int32_t bestLate = 0;
+        for (int8_t i = 0; i < _count; i++) {
+            const HartDevice_t &dev = _devs[i];
+            if (!dev.identified) {
+                if (dev.lastTry == 0 || now - dev.lastTry >= dev.period) return i;
+                continue;
+            }
+            const int32_t late = dev.vars.valid ? (int32_t)(now - dev.vars.timestamp - dueAfter(dev)) : INT32_MAX;
+            if (late >= bestLate) {
+                bestLate = late;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Envia o comando 0 (identificação) ou 3 (variáveis dinâmicas) ao dispositivo.
+     */
+    void request(int8_t i, uint32_t now) {
+        HartDevice_t &dev = _devs[i];
+        uint8_t frame[5 + 1 + 5 + 2 + 1];
+        size_t len;
+        if (!dev.identified) {
+            const uint8_t addr = 0x80 | (dev.pollAddr & 0x3F);
+            _waitCmd = 0;
+            len = hartBuildRequest(frame, &addr, 1, 0);
+        } else {
+            _waitCmd = 3;
+            len = hartBuildRequest(frame, dev.longAddr, 5, 3);
+        }
+        _serial.write(frame, len);
+        dev.lastTry = now;
+        _waiting = i;
+        _sentAt = now;
+    }
+
+    /**
+     * @brief Localiza o dispositivo que originou um frame de resposta ou de burst.
+     */
+    int8_t findDevice(const HartFrame_t &f) const {
+        for (int8_t i = 0; i < _count; i++) {
+            const HartDevice_t &dev = _devs[i];
+            if (f.addrLen == 1) {
+                if ((f.addr[0] & 0x3F) == dev.pollAddr) return i;
+            } else if (dev.identified && (f.addr[0] & 0x3F) == (dev.longAddr[0] & 0x3F) &&
+                       memcmp(&f.addr[1], &dev.longAddr[1], 4) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Atualiza o cache a partir de uma resposta (ACK) ou de um frame de burst (BACK).
+     */
+    void handleFrame(const HartFrame_t &f) {
+        const uint8_t type = f.delimiter & 0x07;
+        if (type != HART_DELIM_ACK && type != HART_DELIM_BACK) return; // Ignora requisições de outros mestres.
+        const int8_t i = findDevice(f);
+        if (i < 0) return;
+        HartDevice_t &dev = _devs[i];
+        dev.burst = (f.addr[0] & 0x40) != 0;
+        // Só a resposta ao comando enviado libera o barramento: um burst do mesmo
+        // dispositivo ou a resposta a outro mestre não encerra a espera.
+        const bool reply = i == _waiting && type == HART_DELIM_ACK && f.command == _waitCmd;
+        if (f.byteCount < 2 || (f.data[0] & 0x80)) { // Erro de comunicação informado pelo escravo.
+            if (reply) {
+                fail(dev);
+                _waiting = -1;
+            }
+            return;
+        }
+        if (f.command == 0 && f.byteCount >= 14) {
+            dev.longAddr[0] = 0x80 | (f.data[3] & 0x3F); // Fabricante, com o bit de mestre primário.
+            dev.longAddr[1] = f.data[4];                 // Tipo de dispositivo.
+            memcpy(&dev.longAddr[2], &f.data[11], 3);    // Número de série.
+            dev.identified = true;
+        } else if (f.command == 3 && f.byteCount >= 6) {
+            HartDynVars_t &v = dev.vars;
+            float *vals[4] = {&v.pv, &v.sv, &v.tv, &v.qv};
+            v.current = hartGetFloat(&f.data[2]);
+            v.nVars = 0;
+            for (uint8_t off = 6; off + 5 <= f.byteCount && v.nVars < 4; off += 5, v.nVars++) {
+                v.units[v.nVars] = f.data[off];
+                *vals[v.nVars] = hartGetFloat(&f.data[off + 1]);
+            }
+            v.status = f.data[1];
+            v.timestamp = millis();
+            v.valid = true;
+        }
+        if (reply) _waiting = -1;
+        dev.failures = 0;
+    }
+
+    /**
+     * @brief Contabiliza uma falha; após HART_MAX_RETRIES o dispositivo é reidentificado.
+     */
+    void fail(HartDevice_t &dev) {
+        if (++dev.failures >= HART_MAX_RETRIES) {
+            dev.identified = false;
+            dev.failures = 0;
+        }
+    }
+
+    HardwareSerial &_serial = Serial2;
+    HartFrameParser _parser;
+    HartDevice_t _devs[HART_MAX_DEVICES];
+    uint8_t _count = 0;
+    int8_t _waiting = -1;    ///< Dispositivo aguardando resposta (-1 se o barramento está livre).
+    uint8_t _waitCmd = 0;    ///< Comando da requisição pendente.
+    uint32_t _sentAt = 0;    ///< Instante (millis) do envio da última requisição.
+};
+
+#endif
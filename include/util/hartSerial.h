@@ -2,6 +2,145 @@
 #define HART_SERIAL_H
 
 #include <Arduino.h>
+
+#ifndef HART_MAX_DATA
+/**
+ * @brief Tamanho máximo do campo de dados de um frame HART aceito pelo parser.
+ */
+#define HART_MAX_DATA 32
+#endif
+
+#define HART_DELIM_BACK 0x01    ///< Tipo de frame: burst (escravo -> mestre, sem requisição).
+#define HART_DELIM_STX 0x02     ///< Tipo de frame: requisição do mestre.
+#define HART_DELIM_ACK 0x06     ///< Tipo de frame: resposta do escravo.
+#define HART_DELIM_LONG 0x80    ///< Bit de endereço longo (5 bytes) no delimitador.
+
+/**
+ * @struct HartFrame_t
+ * @brief Frame HART decodificado (sem preâmbulo e sem checksum).
+ */
+typedef struct {
+    uint8_t delimiter;            ///< Delimitador (tipo do frame e tamanho do endereço).
+    uint8_t addr[5];              ///< Endereço curto (addr[0]) ou longo (addr[0..4]).
+    uint8_t addrLen;              ///< 1 para endereço curto, 5 para endereço longo.
+    uint8_t command;              ///< Número do comando HART.
+    uint8_t byteCount;            ///< Quantidade de bytes do campo de dados.
+    uint8_t data[HART_MAX_DATA];  ///< Campo de dados (inclui os 2 bytes de status em respostas).
+} HartFrame_t;
+
+/**
+ * @brief Lê um float IEEE754 big-endian de um campo de dados HART.
+ */
+inline float hartGetFloat(const uint8_t *p) {
+    const uint32_t u = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/**
+ * @class HartFrameParser
+ * @brief Máquina de estados que monta frames HART byte a byte.
+ *
+ * Não bloqueia e não aloca memória: basta entregar cada byte recebido em parse().
+ * Quando um frame completo e com checksum válido é reconhecido, parse() retorna true
+ * e o frame fica disponível em frame() até o próximo byte.
+ */
+class HartFrameParser {
+public:
+    /**
+     * @brief Descarta qualquer frame parcialmente recebido.
+     */
+    void reset() { _state = WAIT_PREAMBLE; _preambles = 0; }
+
+    /**
+     * @brief Processa um byte recebido do modem.
+     * @param b Byte recebido.
+     * @return true se um frame completo e válido acabou de ser montado.
+     */
+    bool parse(uint8_t b) {
+        switch (_state) {
+        case WAIT_PREAMBLE:
+            _preambles = (b == 0xFF) ? _preambles + 1 : 0;
+            if (_preambles >= 2) _state = WAIT_DELIMITER;
+            break;
+        case WAIT_DELIMITER:
+            if (b == 0xFF) break; // Preâmbulo mais longo que o mínimo.
+            _frame.delimiter = b;
+            _frame.addrLen = (b & HART_DELIM_LONG) ? 5 : 1;
+            _checksum = b;
+            _index = 0;
+            _state = ((b & 0x07) == HART_DELIM_BACK || (b & 0x07) == HART_DELIM_STX || (b & 0x07) == HART_DELIM_ACK) ? READ_ADDRESS : WAIT_PREAMBLE;
+            _preambles = 0;
+            break;
+        case READ_ADDRESS:
+            _frame.addr[_index++] = b;
+            _checksum ^= b;
+            if (_index >= _frame.addrLen) _state = READ_COMMAND;
+            break;
+        case READ_COMMAND:
+            _frame.command = b;
+            _checksum ^= b;
+            _state = READ_COUNT;
+            break;
+        case READ_COUNT:
+            _frame.byteCount = b;
+            _checksum ^= b;
+            _index = 0;
+            _state = (b > HART_MAX_DATA) ? WAIT_PREAMBLE : (b == 0 ? READ_CHECKSUM : READ_DATA);
+            break;
+        case READ_DATA:
+            _frame.data[_index++] = b;
+            _checksum ^= b;
+            if (_index >= _frame.byteCount) _state = READ_CHECKSUM;
+            break;
+        case READ_CHECKSUM:
+            _state = WAIT_PREAMBLE;
+            _preambles = 0;
+            return _checksum == b;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Último frame válido montado pelo parser.
+     */
+    const HartFrame_t &frame() const { return _frame; }
+
+private:
+    enum { WAIT_PREAMBLE, WAIT_DELIMITER, READ_ADDRESS, READ_COMMAND, READ_COUNT, READ_DATA, READ_CHECKSUM } _state = WAIT_PREAMBLE;
+    uint8_t _preambles = 0;
+    uint8_t _index = 0;
+    uint8_t _checksum = 0;
+    HartFrame_t _frame;
+};
+
+/**
+ * @brief Monta um frame de requisição HART (STX) com preâmbulo e checksum.
+ *
+ * @param out Buffer de saída (mínimo 5 + 1 + addrLen + 2 + len + 1 bytes).
+ * @param addr Endereço do escravo (1 ou 5 bytes, já com o bit de mestre primário).
+ * @param addrLen 1 para endereço curto, 5 para endereço longo.
+ * @param command Número do comando.
+ * @param data Campo de dados da requisição (pode ser NULL se len == 0).
+ * @param len Quantidade de bytes de dados.
+ * @return Número de bytes escritos em out.
+ */
+inline size_t hartBuildRequest(uint8_t *out, const uint8_t *addr, uint8_t addrLen, uint8_t command, const uint8_t *data = NULL, uint8_t len = 0) {
+    size_t n = 0;
+    for (uint8_t i = 0; i < 5; i++) out[n++] = 0xFF;
+    const size_t start = n;
+    out[n++] = HART_DELIM_STX | (addrLen == 5 ? HART_DELIM_LONG : 0);
+    for (uint8_t i = 0; i < addrLen; i++) out[n++] = addr[i];
+    out[n++] = command;
+    out[n++] = len;
+    for (uint8_t i = 0; i < len; i++) out[n++] = data[i];
+    uint8_t checksum = 0;
+    for (size_t i = start; i < n; i++) checksum ^= out[i];
+    out[n++] = checksum;
+    return n;
+}
+
 class HartSerial {
 public:
     void begin() {
@@ -25,4 +164,4 @@ private:
     uint32_t baudRate;
 };
 
-#endif
\ No newline at end of file
+#endif
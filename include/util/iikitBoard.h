@@ -0,0 +1,108 @@
+/**
+ * @file iikitBoard.h
+ * @brief Descritor da placa IIKit mini: pinos, canais do ADS1115 e periféricos presentes.
+ *
+ * IIKitmini_t recebe o descritor como parâmetro de template; todos os campos são constexpr,
+ * então os pinos viram constantes no acesso direto aos registradores (gpioFast.h) e os
+ * periféricos desabilitados são substituídos pelas classes vazias de nullDevices_c.h.
+ *
+ * Variantes da placa derivam de IIKitminiBoard e redefinem apenas o que muda. O descritor
+ * é escolhido por IIKIT_BOARD, definido antes de incluir iikitmini.h:
+ * @code
+ * #include "util/iikitBoard.h"
+ * struct PlacaSemDisplay : IIKitminiBoard {
+ *     static constexpr bool hasDisplay = false;
+ *     static constexpr uint8_t pinRELE = 13;
+ * };
+ * #define IIKIT_BOARD PlacaSemDisplay
+ * #include "iikitmini.h"
+ * @endcode
+ */
+
+#ifndef __IIKIT_BOARD_H
+#define __IIKIT_BOARD_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+
+/********** GPIO DEFINITIONS ***********/
+#define def_pin_ADC1 36    ///< GPIO para entrada ADC1. ADC1_CHANNEL_0
+#define def_pin_ADC2 39    ///< GPIO para entrada ADC2. ADC1_CHANNEL_3
+#define def_pin_RTN2 35    ///< GPIO para botão retentivo 2.
+#define def_pin_PUSH1 34   ///< GPIO para botão push 1.
+#define def_pin_PWM 33     ///< GPIO para saída PWM.
+#define def_pin_PUSH2 32    ///< GPIO para botão push 2.
+#define def_pin_RELE 27    ///< GPIO para relé.
+#define def_pin_W4a20_1 26 ///< GPIO para saída 4-20mA 1.
+#define def_pin_DAC1 25    ///< GPIO para saída DAC1.
+#define def_pin_D1 23      ///< GPIO para I/O digital 1.
+#define def_pin_SCL 22     ///< GPIO para SCL do display OLED.
+#define def_pin_SDA 21     ///< GPIO para SDA do display OLED.
+#define def_pin_D2 19      ///< GPIO para I/O digital 2.
+#define def_pin_D3 18      ///< GPIO para I/O digital 3.
+///< GPIO15 - ESP_PROG_TDO:6
+///< GPIO14 - ESP_PROG_TMS:2
+///< GPIO13 - ESP_PROG_TCK:4
+///< GPIO12 - ESP_PROG_TDI:8
+#define def_pin_D4 4      ///< GPIO para I/O digital 4.
+///< GPIO3  - ESP_COM_TX:3
+#define def_pin_RTN1 2    ///< GPIO para botão retentivo 1.
+///< GPIO1  - ESP_COM_RX:5
+///< GPIO0  - ESP_COM_BOOT:6
+///< ESPEN  - ESP_COM_EN:1
+
+/**
+ * @struct IIKitminiBoard
+ * @brief Descritor da placa IIKit mini padrão.
+ */
+struct IIKitminiBoard {
+    /** Pinos */
+    static constexpr uint8_t pinADC1 = def_pin_ADC1;
+    static constexpr uint8_t pinADC2 = def_pin_ADC2;
+    static constexpr uint8_t pinRTN1 = def_pin_RTN1;
+    static constexpr uint8_t pinRTN2 = def_pin_RTN2;
+    static constexpr uint8_t pinPUSH1 = def_pin_PUSH1;
+    static constexpr uint8_t pinPUSH2 = def_pin_PUSH2;
+    static constexpr uint8_t pinPWM = def_pin_PWM;
+    static constexpr uint8_t pinRELE = def_pin_RELE;
+    static constexpr uint8_t pinW4a20_1 = def_pin_W4a20_1;
+    static constexpr uint8_t pinDAC1 = def_pin_DAC1;
+    static constexpr uint8_t pinD1 = def_pin_D1;
+    static constexpr uint8_t pinD2 = def_pin_D2;
+    static constexpr uint8_t pinD3 = def_pin_D3;
+    static constexpr uint8_t pinD4 = def_pin_D4;
+    static constexpr uint8_t pinSDA = def_pin_SDA;
+    static constexpr uint8_t pinSCL = def_pin_SCL;
+
+    /**
+     * Canais e timers do LEDC (modo alta velocidade). Com o mapeamento do Arduino core, os
+     * canais 6 e 7 e os timers 2 e 3 equivalem aos canais 4 a 7 de ledcSetup(): a aplicação
+     * deve usar os canais 0 a 3 ou trocar estes valores em uma variante da placa.
+     */
+    static constexpr ledc_channel_t ledcPwmChannel = LEDC_CHANNEL_6;
+    static constexpr ledc_timer_t ledcPwmTimer = LEDC_TIMER_2;
+    static constexpr ledc_channel_t ledc4a20Channel = LEDC_CHANNEL_7;
+    static constexpr ledc_timer_t ledc4a20Timer = LEDC_TIMER_3;
+
+    /** Canais do ADS1115 */
+    static constexpr uint8_t adsPot1 = 1;
+    static constexpr uint8_t adsPot2 = 0;
+    static constexpr uint8_t ads4a20_1 = 3;
+    static constexpr uint8_t ads4a20_2 = 2;
+
+    /** Periféricos presentes */
+    static constexpr bool hasDisplay = true;  ///< Display OLED SSD1306.
+    static constexpr bool hasAds1115 = true;  ///< Conversor ADS1115 (potenciômetros e 4-20mA).
+    static constexpr bool hasAdcDma = true;   ///< Entradas ADC1/ADC2 do ESP32 (AdcDmaEsp.h).
+#ifdef IIKIT_HART
+    static constexpr bool hasHart = true;     ///< Modem HART na Serial2.
+#else
+    static constexpr bool hasHart = false;    ///< Modem HART na Serial2 (defina IIKIT_HART).
+#endif
+};
+
+#ifndef IIKIT_BOARD
+#define IIKIT_BOARD IIKitminiBoard ///< Descritor da placa, também usado pelos módulos de util/ (jalarm.h).
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file iikitConfig.h
+ * @brief Configuração persistente do kit em NVS, com esquema definido em tempo de compilação.
+ *
+ * Cada parâmetro é declarado uma única vez na lista IIKIT_CONFIG_FIELDS (nome, tipo,
+ * valor padrão, mínimo e máximo). A partir dela são gerados a estrutura IIKitConfig_t,
+ * os valores padrão, a validação de faixa e os comandos da serial.
+ *
+ * A estrutura é gravada na NVS como um único blob binário, precedido de um cabeçalho com
+ * versão, tamanho e CRC32. Na inicialização basta uma leitura (configLoad()); se o blob
+ * não existir, estiver corrompido ou for de outra versão, os valores padrão são usados.
+ *
+ * Comandos pela serial (registrados com WSerialmini_c::addCommand):
+ * - "cfg"               lista todos os parâmetros;
+ * - "cfg nome"          mostra um parâmetro;
+ * - "cfg nome valor"    altera um parâmetro na RAM;
+ * - "cfg save"          grava a configuração na NVS;
+ * - "cfg reset"         restaura os valores padrão (na RAM).
+ */
+
+#ifndef __IIKIT_CONFIG_H
+#define __IIKIT_CONFIG_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <type_traits>
+#include "ledcOut.h"
+
+#ifndef IIKIT_CONFIG_FIELDS
+/**
+ * @brief Esquema da configuração: X(nome, tipo, padrão, mínimo, máximo).
+ *
+ * adsGain é o índice do ganho do ADS1115 (0 = 2/3, 1 = 1, 2 = 2, 3 = 4, 4 = 8, 5 = 16),
+ * que corresponde aos bits de PGA de adsGain_t deslocados de 9 posições.
+ * out4a20Cal4 e out4a20Cal20 são as frações do duty que produzem 4 mA e 20 mA na saída 4-20mA.
+ * debounceMs é o debounce dos DigitalINDebounce criados com DEBOUNCE_CFG (o padrão), lido a
+ * cada update(). adcSamplePeriod e adcCallbackPeriod (us) são os padrões de adcDmaSetup() e
+ * valem na próxima chamada dela (normalmente após "cfg save" e reinício).
+ *
+ * Pode ser redefinido pela aplicação antes de incluir este arquivo; nesse caso
+ * incremente também IIKIT_CONFIG_VERSION.
+ */
+#define IIKIT_CONFIG_FIELDS(X)                                   \
+    X(serialBaud, uint32_t, 115200UL, 1200UL, 2000000UL)         \
+    X(adsGain, uint8_t, 0, 0, 5)                                 \
+    X(debounceMs, uint16_t, 50, 0, 5000)                         \
+    X(adcSamplePeriod, uint32_t, 1000UL, 10UL, 1000000UL)        \
+    X(adcCallbackPeriod, uint32_t, 100000UL, 1000UL, 10000000UL) \
+    X(pwmFreq, uint32_t, 5000UL, 1UL, 1000000UL)                 \
+    X(pwmBits, uint8_t, 12, 1, 16)                               \
+    X(out4a20Cal4, float, 0.2f, 0.0f, 1.0f)                      \
+    X(out4a20Cal20, float, 1.0f, 0.0f, 1.0f)
+
+#ifndef IIKIT_CONFIG_VALID
+/**
+ * @brief Regras entre parâmetros, além da faixa de cada um: o LEDC precisa conseguir
+ * gerar pwmFreq com pwmBits de resolução.
+ */
+#define IIKIT_CONFIG_VALID(cfg) ledcOutValid((cfg).pwmFreq, (cfg).pwmBits)
+#endif
+#endif
+
+#ifndef IIKIT_CONFIG_VALID
+#define IIKIT_CONFIG_VALID(cfg) true ///< Esquema próprio da aplicação: sem regras entre parâmetros.
+#endif
+
+#ifndef IIKIT_CONFIG_VERSION
+/**
+ * @brief Versão do esquema. Blobs gravados com outra versão são descartados.
+ */
+#define IIKIT_CONFIG_VERSION 2
+#endif
+
+#define IIKIT_CONFIG_MAGIC 0x4B49 ///< "IK" em little-endian.
+
+/**
+ * @struct IIKitConfig_t
+ * @brief Parâmetros configuráveis do kit, gerados a partir de IIKIT_CONFIG_FIELDS.
+ */
+typedef struct {
+#define IIKIT_CONFIG_MEMBER(name, type, def, lo, hi) type name;
+    IIKIT_CONFIG_FIELDS(IIKIT_CONFIG_MEMBER)
+#undef IIKIT_CONFIG_MEMBER
+} IIKitConfig_t;
+
+/**
+ * @struct IIKitConfigBlob_t
+ * @brief Formato gravado na NVS: cabeçalho seguido da configuração.
+ */
+typedef struct {
+    uint16_t magic;       ///< IIKIT_CONFIG_MAGIC.
+    uint16_t version;     ///< IIKIT_CONFIG_VERSION.
+    uint16_t size;        ///< sizeof(IIKitConfig_t).
+    uint16_t reserved;    ///< Reservado (zero).
+    uint32_t crc;         ///< CRC32 de cfg.
+    IIKitConfig_t cfg;    ///< Configuração.
+} IIKitConfigBlob_t;
+
+/**
+ * @brief Configuração em uso. Válida após configLoad().
+ */
+IIKitConfig_t IIKitCfg = {
+#define IIKIT_CONFIG_DEFAULT(name, type, def, lo, hi) (type)(def),
+    IIKIT_CONFIG_FIELDS(IIKIT_CONFIG_DEFAULT)
+#undef IIKIT_CONFIG_DEFAULT
+};
+
+/**
+ * @brief Calcula o CRC32 (polinômio 0xEDB88320) de um bloco de memória.
+ */
+uint32_t configCrc32(const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFUL;
+    while (len--) {
+        crc ^= *p++;
+        for (uint8_t k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Restaura os valores padrão de todos os parâmetros (somente na RAM).
+ */
+void configDefaults(void) {
+#define IIKIT_CONFIG_RESET(name, type, def, lo, hi) IIKitCfg.name = (type)(def);
+    IIKIT_CONFIG_FIELDS(IIKIT_CONFIG_RESET)
+#undef IIKIT_CONFIG_RESET
+}
+
+/**
+ * @brief Carrega a configuração da NVS com uma única leitura.
+ *
+ * Se o blob não existir ou for inválido (versão, tamanho ou CRC), os valores padrão são
+ * mantidos. Valores fora da faixa do esquema são substituídos pelo padrão, e uma
+ * configuração que viole IIKIT_CONFIG_VALID é descartada inteira.
+ * @return true se a configuração gravada foi aceita.
+ */
+bool configLoad(void) {
+    IIKitConfigBlob_t blob;
+    Preferences prefs;
+    configDefaults();
+    if (!prefs.begin("iikit", true)) return false;
+    const size_t len = prefs.getBytes("cfg", &blob, sizeof(blob));
+    prefs.end();
+    if (len != sizeof(blob) || blob.magic != IIKIT_CONFIG_MAGIC || blob.version != IIKIT_CONFIG_VERSION ||
+        blob.size != sizeof(IIKitConfig_t) || blob.crc != configCrc32(&blob.cfg, sizeof(IIKitConfig_t))) {
+        return false;
+    }
+#define IIKIT_CONFIG_CHECK(name, type, def, lo, hi) \
+    IIKitCfg.name = (blob.cfg.name >= (type)(lo) && blob.cfg.name <= (type)(hi)) ? blob.cfg.name : (type)(def);
+    IIKIT_CONFIG_FIELDS(IIKIT_CONFIG_CHECK)
+#undef IIKIT_CONFIG_CHECK
+    if (!IIKIT_CONFIG_VALID(IIKitCfg)) {
+        configDefaults();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Grava a configuração em uso na NVS.
+ * @return true se a gravação foi bem-sucedida.
+ */
+bool configSave(void) {
+    IIKitConfigBlob_t blob;
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = IIKIT_CONFIG_MAGIC;
+    blob.version = IIKIT_CONFIG_VERSION;
+    blob.size = sizeof(IIKitConfig_t);
+    blob.cfg = IIKitCfg;
+    blob.crc = configCrc32(&blob.cfg, sizeof(IIKitConfig_t));
+    Preferences prefs;
+    if (!prefs.begin("iikit", false)) return false;
+    const size_t len = prefs.putBytes("cfg", &blob, sizeof(blob));
+    prefs.end();
+    return len == sizeof(blob);
+}
+
+/**
+ * @brief Altera um parâmetro a partir de texto, respeitando a faixa do esquema.
+ *
+ * O texto inteiro precisa ser um número: "abc", "12x" ou "" são rejeitados. Parâmetros
+ * inteiros aceitam apenas inteiros decimais ("12.5" é rejeitado, não truncado).
+ * @return true se o valor foi aceito; caso contrário field não é alterado.
+ */
+template <typename T>
+bool configParse(T &field, const String &value, T lo, T hi) {
+    const char *s = value.c_str();
+    char *end = NULL;
+    const double v = std::is_integral<T>::value ? (double)strtoll(s, &end, 10) : strtod(s, &end);
+    if (end == s || *end != '\0' || !(v >= (double)lo && v <= (double)hi)) return false; // Também rejeita NaN.
+    field = (T)v;
+    return true;
+}
+
+/**
+ * @brief Trata o comando "cfg" recebido pela serial.
+ *
+ * @param out Saída para as respostas (por exemplo, IIKit.WSerial).
+ * @param args Texto após "cfg" (pode ser vazio).
+ */
+template <typename S>
+void configCommand(S &out, String args) {
+    args.trim();
+    const int sp = args.indexOf(' ');
+    String name = (sp < 0) ? args : args.substring(0, sp);
+    String value = (sp < 0) ? String("") : args.substring(sp + 1);
+    value.trim();
+    if (name == "save") {
+        out.println(configSave() ? "cfg: salvo" : "cfg: erro ao salvar");
+        return;
+    }
+    if (name == "reset") {
+        configDefaults();
+        out.println("cfg: padrao restaurado");
+        return;
+    }
+    bool found = false;
+#define IIKIT_CONFIG_CMD(fname, type, def, lo, hi)                                   \
+    if (name.length() == 0 || name == #fname) {                                      \
+        found = true;                                                                \
+        const type prev = IIKitCfg.fname;                                            \
+        if (value.length() > 0 && !configParse<type>(IIKitCfg.fname, value, (type)(lo), (type)(hi))) { \
+            out.print("cfg: valor invalido ");                                       \
+        } else if (!IIKIT_CONFIG_VALID(IIKitCfg)) {                                  \
+            IIKitCfg.fname = prev;                                                   \
+            out.print("cfg: combinacao invalida ");                                  \
+        }                                                                            \
+        out.print(#fname);                                                           \
+        out.print("=");                                                              \
+        out.print(IIKitCfg.fname);                                                   \
+        out.print(" [");                                                             \
+        out.print((type)(lo));                                                       \
+        out.print("..");                                                             \
+        out.print((type)(hi));                                                       \
+        out.print("] padrao ");                                                      \
+        out.println((type)(def));                                                    \
+    }
+    IIKIT_CONFIG_FIELDS(IIKIT_CONFIG_CMD)
+#undef IIKIT_CONFIG_CMD
+    if (!found) {
+        out.print("cfg: parametro desconhecido ");
+        out.println(name);
+    }
+}
+
+#endif
@@ -0,0 +1,362 @@
+/**
+ * @file jalarm.h
+ * @brief Alarmes de processo avaliados por bloco de amostras, com banda morta e retardos.
+ *
+ * Cada alarme da tabela observa um canal e compara o bloco inteiro com seu limite. O bloco
+ * é resumido uma única vez por canal (mínimo, máximo, primeira e última amostra, em uma
+ * passagem sem desvios) e cada alarme decide a partir do resumo, então a latência é de um
+ * bloco e o custo por amostra não depende do número de alarmes.
+ *
+ * Tipos:
+ * - JALARM_HI / JALARM_HIHI: máximo do bloco acima do limite;
+ * - JALARM_LO / JALARM_LOLO: mínimo do bloco abaixo do limite;
+ * - JALARM_DEV: afastamento do setpoint (jalarmSetpoint()) maior que o limite;
+ * - JALARM_ROC: taxa de variação (contagens/s, em módulo) acima do limite;
+ * - JALARM_STUCK: sinal preso em uma faixa de largura <= limite durante delayOn.
+ *
+ * A banda morta afasta o limite de retorno (o alarme só normaliza depois de cruzar o limite
+ * de volta por mais que deadband). delayOn e delayOff exigem que a condição persista antes
+ * de ativar ou normalizar. Cada transição gera um JAlarmEvent_t em uma fila circular
+ * (jalarmPop()). Alarmes marcados como intertravamento acionam o relé diretamente
+ * (Board::pinRELE do descritor da placa, IIKIT_BOARD por padrão, já configurado como saída
+ * por IIKit.setup()) enquanto algum deles estiver ativo. Para outra placa, passe o
+ * descritor como parâmetro de template: jalarmBlock<MinhaPlaca>(b).
+ *
+ * Uso com a aquisição por blocos (jpool.h):
+ * @code
+ * int8_t alta = jalarmAdd(0, JALARM_HIHI, 3800, 50, 200, 1000, true);
+ * void loop() {
+ *     void *item;
+ *     if (jQueueReceive(&filaAdc, &item)) {
+ *         jalarmBlock((jBlock_t *)item);
+ *         jpoolRelease((jBlock_t *)item);
+ *     }
+ *     JAlarmEvent_t ev;
+ *     while (jalarmPop(&ev)) registrar(ev);
+ * }
+ * @endcode
+ */
+
+#ifndef __JALARM_H
+#define __JALARM_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include "iikitBoard.h"
+#include "gpioFast.h"
+#include "jpool.h"
+
+#ifndef NUMALARMS
+/**
+ * @brief Número máximo de alarmes na tabela.
+ */
+#define NUMALARMS 8
+#endif
+
+#ifndef JALARM_EVENTS
+/**
+ * @brief Capacidade da fila de transições.
+ */
+#define JALARM_EVENTS 16
+#endif
+
+#ifndef JALARM_RELAY_ACTIVE
+/**
+ * @brief Nível do pino do relé com intertravamento ativo.
+ */
+#define JALARM_RELAY_ACTIVE HIGH
+#endif
+
+static_assert(NUMALARMS <= 32, "NUMALARMS deve ser no maximo 32");
+
+/** Tipos de alarme */
+#define JALARM_HI 0    ///< Alto.
+#define JALARM_HIHI 1  ///< Muito alto.
+#define JALARM_LO 2    ///< Baixo.
+#define JALARM_LOLO 3  ///< Muito baixo.
+#define JALARM_DEV 4   ///< Desvio em relação ao setpoint.
+#define JALARM_ROC 5   ///< Taxa de variação.
+#define JALARM_STUCK 6 ///< Sensor travado.
+
+/**
+ * @struct JAlarm_t
+ * @brief Configuração e estado de um alarme.
+ */
+typedef struct {
+    uint8_t channel;     ///< Canal observado.
+    uint8_t type;        ///< JALARM_HI, JALARM_LO, ...
+    bool interlock;      ///< true se aciona o relé.
+    bool active;         ///< Estado atual.
+    bool pending;        ///< Condição oposta ao estado atual aguardando o retardo.
+    int16_t setpoint;    ///< Referência do JALARM_DEV.
+    int32_t limit;       ///< Limite (contagens; contagens/s no JALARM_ROC; largura da faixa no JALARM_STUCK).
+    int32_t deadband;    ///< Banda morta para normalizar.
+    uint32_t delayOn;    ///< Persistência (us) para ativar.
+    uint32_t delayOff;   ///< Persistência (us) para normalizar.
+    uint64_t since;      ///< Início (us) da condição pendente.
+    int16_t lo;          ///< Menor valor da janela do JALARM_STUCK.
+    int16_t hi;          ///< Maior valor da janela do JALARM_STUCK.
+} JAlarm_t;
+
+/**
+ * @struct JAlarmEvent_t
+ * @brief Transição de um alarme.
+ */
+typedef struct {
+    uint64_t t;      ///< Instante (us) do fim do bloco que confirmou a transição.
+    int16_t value;   ///< Valor que provocou a transição (extremo do bloco, ou taxa no JALARM_ROC).
+    uint8_t alarm;   ///< Índice do alarme (retornado por jalarmAdd()).
+    bool active;     ///< true = ativou, false = normalizou.
+} JAlarmEvent_t;
+
+/**
+ * @brief Tabela de alarmes.
+ */
+JAlarm_t jalarmStruct[NUMALARMS];
+/**
+ * @brief Número de alarmes registrados.
+ */
+uint8_t jalarmIndex = 0;
+
+JAlarmEvent_t _jalarmEvents[JALARM_EVENTS];  ///< Fila circular de transições.
+uint8_t _jalarmHead = 0;                     ///< Próximo evento a ler.
+uint8_t _jalarmCount = 0;                    ///< Eventos na fila.
+uint32_t _jalarmLost = 0;                    ///< Eventos descartados com a fila cheia.
+uint32_t _jalarmInterlocks = 0;              ///< Mapa dos intertravamentos ativos (bit = alarme).
+portMUX_TYPE _jalarmMux = portMUX_INITIALIZER_UNLOCKED; ///< Protege a fila, os intertravamentos e o relé.
+
+/**
+ * @brief Registra um alarme.
+ * @param channel Canal observado (jBlock_t::channel ou o informado a jalarmEvaluate()).
+ * @param type JALARM_HI, JALARM_HIHI, JALARM_LO, JALARM_LOLO, JALARM_DEV, JALARM_ROC ou JALARM_STUCK.
+ * @param limit Limite do alarme (ver JAlarm_t::limit).
+ * @param deadband Banda morta para normalizar.
+ * @param delayOnMs Persistência (ms) da condição para ativar; no JALARM_STUCK, a janela de observação.
+ * @param delayOffMs Persistência (ms) da normalidade para normalizar.
+ * @param interlock true para acionar o relé enquanto ativo.
+ * @return Índice do alarme, ou -1 se a tabela estiver cheia.
+ */
+int8_t jalarmAdd(uint8_t channel, uint8_t type, int32_t limit, int32_t deadband = 0,
+                 uint32_t delayOnMs = 0, uint32_t delayOffMs = 0, bool interlock = false) {
+    if (jalarmIndex >= NUMALARMS) return -1;
+    JAlarm_t &a = jalarmStruct[jalarmIndex];
+    memset(&a, 0, sizeof(a));
+    a.channel = channel;
+    a.type = type;
+    a.limit = limit;
+    a.deadband = deadband;
+    a.delayOn = delayOnMs * 1000UL;
+    a.delayOff = delayOffMs * 1000UL;
+    a.interlock = interlock;
+    return jalarmIndex++;
+}
+
+/**
+ * @brief Define o setpoint de um alarme JALARM_DEV.
+ */
+void jalarmSetpoint(int8_t id, int16_t setpoint) {
+    if (id >= 0 && id < jalarmIndex) jalarmStruct[id].setpoint = setpoint;
+}
+
+/**
+ * @brief Retorna true se o alarme está ativo.
+ */
+bool jalarmActive(int8_t id) {
+    return id >= 0 && id < jalarmIndex && jalarmStruct[id].active;
+}
+
+/**
+ * @brief Retira a transição mais antiga da fila.
+ * @return false se a fila estiver vazia.
+ */
+bool jalarmPop(JAlarmEvent_t *ev) {
+    portENTER_CRITICAL(&_jalarmMux);
+    if (_jalarmCount == 0) {
+        portEXIT_CRITICAL(&_jalarmMux);
+        return false;
+    }
+    *ev = _jalarmEvents[_jalarmHead];
+    _jalarmHead = (_jalarmHead + 1) % JALARM_EVENTS;
+    _jalarmCount--;
+    portEXIT_CRITICAL(&_jalarmMux);
+    return true;
+}
+
+/**
+ * @brief Retorna quantas transições foram descartadas com a fila cheia.
+ */
+uint32_t jalarmLost(void) {
+    return _jalarmLost;
+}
+
+/**
+ * @brief Enfileira uma transição e atualiza o relé de intertravamento.
+ *
+ * O mapa de intertravamentos e o relé mudam na mesma seção crítica: canais avaliados por
+ * tarefas diferentes não deixam o relé em um estado que não corresponde ao mapa.
+ */
+template <class Board>
+void _jalarmTransition(uint8_t id, bool active, int16_t value, uint64_t t) {
+    JAlarm_t &a = jalarmStruct[id];
+    a.active = active;
+    a.pending = false;
+    portENTER_CRITICAL(&_jalarmMux);
+    if (a.interlock) {
+        if (active) _jalarmInterlocks |= 1UL << id;
+        else _jalarmInterlocks &= ~(1UL << id);
+        gpioWrite<Board::pinRELE>(_jalarmInterlocks != 0 ? JALARM_RELAY_ACTIVE : !JALARM_RELAY_ACTIVE);
+    }
+    if (_jalarmCount == JALARM_EVENTS) {
+        _jalarmLost++;
+    } else {
+        JAlarmEvent_t &ev = _jalarmEvents[(_jalarmHead + _jalarmCount) % JALARM_EVENTS];
+        ev.t = t;
+        ev.value = value;
+        ev.alarm = id;
+        ev.active = active;
+        _jalarmCount++;
+    }
+    portEXIT_CRITICAL(&_jalarmMux);
+}
+
+/**
+ * @brief Avalia todos os alarmes de um canal contra um bloco de amostras.
+ * @param channel Canal do bloco.
+ * @param data Amostras.
+ * @param count Número de amostras.
+ * @param t0 Instante (us) da primeira amostra.
+ * @param period Período de amostragem (us).
+ * @tparam Board Descritor da placa com o pino do relé (pinRELE).
+ */
+template <class Board = IIKIT_BOARD>
+void jalarmEvaluate(uint8_t channel, const int16_t *data, size_t count, uint64_t t0, uint32_t period) {
+    if (count == 0) return;
+    // Resumo do bloco em uma passagem, compartilhado por todos os alarmes do canal.
+    int16_t lo = data[0];
+    int16_t hi = data[0];
+    for (size_t i = 1; i < count; i++) {
+        const int16_t v = data[i];
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+    }
+    const int32_t delta = (int32_t)data[count - 1] - data[0];
+    const int32_t roc = (count > 1 && period > 0) ? (int32_t)((int64_t)delta * 1000000LL / ((int64_t)(count - 1) * period)) : 0;
+    const uint64_t tEnd = t0 + (uint64_t)count * period;
+
+    for (uint8_t id = 0; id < jalarmIndex; id++) {
+        JAlarm_t &a = jalarmStruct[id];
+        if (a.channel != channel) continue;
+        // Limite de ativação, ou de retorno (afastado pela banda morta) se já está ativo.
+        const int32_t db = a.active ? a.deadband : 0;
+        bool cond = false;
+        int16_t value = hi;
+        switch (a.type) {
+        case JALARM_HI:
+        case JALARM_HIHI:
+            cond = hi > a.limit - db;
+            break;
+        case JALARM_LO:
+        case JALARM_LOLO:
+            cond = lo < a.limit + db;
+            value = lo;
+            break;
+        case JALARM_DEV:
+            cond = hi > a.setpoint + a.limit - db || lo < a.setpoint - a.limit + db;
+            value = (hi - a.setpoint) >= (a.setpoint - lo) ? hi : lo;
+            break;
+        case JALARM_ROC:
+            cond = (roc < 0 ? -roc : roc) > a.limit - db;
+            value = (int16_t)constrain(roc, -32768, 32767);
+            break;
+        case JALARM_STUCK:
+            if (!a.active && !a.pending) {
+                a.lo = lo;
+                a.hi = hi;
+            } else {
+                a.lo = lo < a.lo ? lo : a.lo;
+                a.hi = hi > a.hi ? hi : a.hi;
+            }
+            cond = a.hi - a.lo <= a.limit + db;
+            value = data[count - 1];
+            if (!cond && !a.active) {
+                // A faixa abriu: a janela recomeça neste bloco.
+                a.lo = lo;
+                a.hi = hi;
+                a.since = t0;
+                a.pending = hi - lo <= a.limit;
+                continue;
+            }
+            break;
+        default:
+            continue;
+        }
+        if (cond == a.active) {
+            a.pending = false;
+            continue;
+        }
+        if (!a.pending) {
+            a.pending = true;
+            a.since = t0;
+        }
+        if (tEnd - a.since >= (a.active ? a.delayOff : a.delayOn)) {
+            _jalarmTransition<Board>(id, cond, value, tEnd);
+            if (a.type == JALARM_STUCK && !cond) {
+                a.lo = lo;
+                a.hi = hi;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Avalia os alarmes do canal de um bloco do pool (jpool.h).
+ */
+template <class Board = IIKIT_BOARD>
+void jalarmBlock(const jBlock_t *b) {
+    jalarmEvaluate<Board>(b->channel, b->data, b->count, b->t0, b->period);
+}
+
+/**
+ * @brief Avalia um buffer entregue a um CallbackADC (AdcDmaEsp.h), que termina agora.
+ * @param channel Canal do buffer.
+ * @param data Amostras.
+ * @param count Número de amostras.
+ * @param period Período de amostragem (us).
+ */
+template <class Board = IIKIT_BOARD>
+void jalarmEvaluate(uint8_t channel, const int16_t *data, size_t count, uint32_t period) {
+    const uint64_t now = esp_timer_get_time();
+    const uint64_t span = (uint64_t)count * period;
+    jalarmEvaluate<Board>(channel, data, count, now > span ? now - span : 0, period);
+}
+
+/**
+ * @brief Trata o comando "alarm" recebido pela serial.
+ *
+ * Uma linha por alarme: "n ch=... type=... limit=... active=..." e uma linha final com
+ * os eventos descartados.
+ * @param out Saída para as respostas (por exemplo, IIKit.WSerial).
+ * @param args Ignorado.
+ */
+template <typename S>
+void jalarmCommand(S &out, String args) {
+    (void)args;
+    static const char *const names[] = {"HI", "HIHI", "LO", "LOLO", "DEV", "ROC", "STUCK"};
+    for (uint8_t i = 0; i < jalarmIndex; i++) {
+        const JAlarm_t &a = jalarmStruct[i];
+        out.print(i);
+        out.print(" ch=");
+        out.print(a.channel);
+        out.print(" type=");
+        out.print(a.type <= JALARM_STUCK ? names[a.type] : "?");
+        out.print(" limit=");
+        out.print(a.limit);
+        out.print(" active=");
+        out.println(a.active ? 1 : 0);
+    }
+    out.print("alarm lost=");
+    out.println(_jalarmLost);
+}
+
+#endif
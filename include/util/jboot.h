@@ -0,0 +1,119 @@
+/**
+ * @file jboot.h
+ * @brief Medição das etapas da inicialização e do tempo até o primeiro ciclo de controle.
+ *
+ * Cada etapa registra o instante de início e a duração (us desde o boot, pelo esp_timer).
+ * Etapas da tarefa de inicialização em segundo plano e do setup() podem se sobrepor, por
+ * isso cada uma é aberta e fechada explicitamente:
+ * @code
+ * const uint8_t st = jbootBegin("sensor");
+ * sensor.begin();
+ * jbootEnd(st);
+ * @endcode
+ *
+ * jbootFirstCycle() marca o primeiro ciclo de controle (IIKit.loop() a chama). O comando
+ * de serial "boot" lista as etapas e o tempo até o primeiro ciclo.
+ */
+
+#ifndef __JBOOT_H
+#define __JBOOT_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#ifndef NUMBOOTSTAGES
+/**
+ * @brief Número máximo de etapas registradas.
+ */
+#define NUMBOOTSTAGES 8
+#endif
+
+/**
+ * @struct JBootStage_t
+ * @brief Uma etapa da inicialização.
+ */
+typedef struct {
+    const char *name;   ///< Nome exibido no relatório.
+    uint32_t start;     ///< Início (us desde o boot).
+    uint32_t us;        ///< Duração (us); 0 enquanto não terminou.
+} JBootStage_t;
+
+/**
+ * @brief Etapas registradas.
+ */
+JBootStage_t jbootStages[NUMBOOTSTAGES];
+/**
+ * @brief Número de etapas registradas.
+ */
+uint8_t jbootIndex = 0;
+
+/** Instante (us desde o boot) do primeiro ciclo de controle; 0 = ainda não ocorreu */
+uint32_t _jbootFirstCycle = 0;
+/** Protege o registro entre o setup() e a tarefa de inicialização */
+portMUX_TYPE _jbootMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Abre uma etapa e retorna seu índice (ou NUMBOOTSTAGES se não houver espaço).
+ */
+uint8_t jbootBegin(const char *name) {
+    const uint32_t now = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&_jbootMux);
+    const uint8_t i = jbootIndex < NUMBOOTSTAGES ? jbootIndex++ : NUMBOOTSTAGES;
+    portEXIT_CRITICAL(&_jbootMux);
+    if (i < NUMBOOTSTAGES) {
+        jbootStages[i].name = name;
+        jbootStages[i].start = now;
+        jbootStages[i].us = 0;
+    }
+    return i;
+}
+
+/**
+ * @brief Fecha a etapa aberta por jbootBegin().
+ */
+void jbootEnd(uint8_t stage) {
+    if (stage >= NUMBOOTSTAGES) return;
+    const uint32_t us = (uint32_t)esp_timer_get_time() - jbootStages[stage].start;
+    jbootStages[stage].us = us > 0 ? us : 1;
+}
+
+/**
+ * @brief Marca o primeiro ciclo de controle (apenas a primeira chamada tem efeito).
+ */
+inline void jbootFirstCycle(void) {
+    if (_jbootFirstCycle == 0) _jbootFirstCycle = (uint32_t)esp_timer_get_time();
+}
+
+/**
+ * @brief Retorna o tempo (us desde o boot) até o primeiro ciclo de controle, ou 0.
+ */
+uint32_t jbootFirstCycleUs(void) {
+    return _jbootFirstCycle;
+}
+
+/**
+ * @brief Trata o comando "boot" recebido pela serial.
+ *
+ * Responde "boot first=..." (us desde o boot até o primeiro ciclo de controle) e uma linha
+ * por etapa: "nome start=... us=..." ("us=..." vazio se a etapa ainda não terminou).
+ * @param out Saída para as respostas (por exemplo, IIKit.WSerial).
+ * @param args Ignorado.
+ */
+template <typename S>
+void jbootCommand(S &out, String args) {
+    (void)args;
+    out.print("boot first=");
+    out.println(_jbootFirstCycle);
+    for (uint8_t i = 0; i < jbootIndex && i < NUMBOOTSTAGES; i++) {
+        const JBootStage_t &s = jbootStages[i];
+        out.print(s.name);
+        out.print(" start=");
+        out.print(s.start);
+        out.print(" us=");
+        if (s.us != 0) out.println(s.us);
+        else out.println("");
+    }
+}
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file jclock.h
+ * @brief Relógio de amostragem: instante exato de cada bloco a partir da contagem de amostras.
+ *
+ * Um conversor com DMA amostra em ritmo constante, mas o programa só vê os blocos quando os
+ * lê, com atraso variável. O relógio conta as amostras entregues (o índice da amostra é a
+ * referência de tempo) e as converte em instantes do esp_timer:
+ * - fase: o instante previsto da última amostra do bloco é comparado com o instante da
+ *   leitura. Como a leitura nunca acontece antes da amostra, um erro negativo corrige a
+ *   previsão na hora e um erro positivo (atraso da leitura) só a puxa lentamente
+ *   (1/2^JCLOCK_SHIFT), acompanhando o menor atraso;
+ * - frequência: o período real é estimado pela razão entre o avanço da previsão já
+ *   corrigida e as amostras contadas desde a origem, limitado a ±JCLOCK_MAX_PPM do nominal
+ *   (deriva do cristal do I2S em relação ao do esp_timer);
+ * - perdas: se a leitura atrasar mais do que o buffer do DMA comporta (ringUs), amostras
+ *   foram sobrescritas. O relógio é reancorado na leitura e o número de sequência pula
+ *   uma posição, o que sinaliza a lacuna para quem consome os blocos.
+ *
+ * Cada bloco recebe {seq, t0, period}: blocos consecutivos têm seq consecutivos e t0 do
+ * bloco seguinte = t0 + count * period, então fontes diferentes (ADC interno, ADS1115,
+ * bordas digitais) podem ser alinhadas e reamostradas pelo instante.
+ */
+
+#ifndef __JCLOCK_H
+#define __JCLOCK_H
+
+#include <Arduino.h>
+
+#ifndef JCLOCK_SHIFT
+/**
+ * @brief Ganho (1/2^JCLOCK_SHIFT) da correção de fase para erros positivos.
+ */
+#define JCLOCK_SHIFT 8
+#endif
+
+#ifndef JCLOCK_RATE_SAMPLES
+/**
+ * @brief Amostras contadas desde a origem antes de estimar o período real.
+ */
+#define JCLOCK_RATE_SAMPLES 4096
+#endif
+
+#ifndef JCLOCK_MAX_PPM
+/**
+ * @brief Maior desvio aceito do período estimado em relação ao nominal (ppm).
+ */
+#define JCLOCK_MAX_PPM 2000
+#endif
+
+/**
+ * @struct jClock_t
+ * @brief Estado de um relógio de amostragem.
+ */
+typedef struct {
+    uint32_t seq;        ///< Número de sequência do próximo bloco.
+    uint32_t nominalNs;  ///< Período nominal (ns).
+    uint32_t periodNs;   ///< Período estimado (ns).
+    uint32_t ringUs;     ///< Maior atraso de leitura sem perda de amostras (us).
+    uint64_t next;       ///< Índice da próxima amostra.
+    int64_t anchorNs;    ///< Instante previsto (ns) da amostra next.
+    bool synced;         ///< false até o primeiro bloco ou depois de uma lacuna.
+    uint64_t originK;    ///< Índice da amostra da origem da estimativa de frequência.
+    int64_t originNs;    ///< Instante previsto (ns) da amostra originK; 0 = origem não fixada.
+    uint32_t gaps;       ///< Lacunas detectadas.
+} jClock_t;
+
+/**
+ * @brief Inicializa um relógio.
+ * @param clk Relógio.
+ * @param periodUs Período nominal de amostragem (us).
+ * @param ringUs Duração do buffer do conversor (us); atrasos maiores indicam perda. 0 = sem detecção.
+ */
+void jclockInit(jClock_t *clk, uint32_t periodUs, uint32_t ringUs = 0) {
+    memset(clk, 0, sizeof(*clk));
+    clk->nominalNs = periodUs * 1000UL;
+    clk->periodNs = clk->nominalNs;
+    clk->ringUs = ringUs;
+}
+
+/**
+ * @brief Registra um bloco de amostras recém-lido e retorna o instante da primeira amostra.
+ * @param clk Relógio.
+ * @param count Amostras do bloco.
+ * @param nowUs Instante (esp_timer, us) da leitura.
+ * @param seq Recebe o número de sequência do bloco (pode ser NULL).
+ * @return Instante (us) da primeira amostra do bloco.
+ */
+uint64_t jclockStamp(jClock_t *clk, size_t count, int64_t nowUs, uint32_t *seq = NULL) {
+    const int64_t nowNs = nowUs * 1000LL;
+    const int64_t lastNs = (int64_t)(count > 0 ? count - 1 : 0) * clk->periodNs;
+    if (clk->synced) {
+        // Erro da previsão para a última amostra do bloco (>= 0 se a previsão estiver certa).
+        const int64_t err = nowNs - (clk->anchorNs + lastNs);
+        if (clk->ringUs != 0 && err > (int64_t)clk->ringUs * 1000LL + clk->periodNs) {
+            clk->synced = false; // Amostras sobrescritas no DMA: reancora e marca a lacuna.
+            clk->seq++;
+            clk->gaps++;
+        } else if (err < 0) {
+            clk->anchorNs += err;
+        } else {
+            clk->anchorNs += err >> JCLOCK_SHIFT;
+        }
+    }
+    if (!clk->synced) {
+        clk->synced = true;
+        clk->anchorNs = nowNs - lastNs;
+        clk->originK = clk->next; // O período estimado até aqui continua valendo.
+        clk->originNs = 0;
+    }
+
+    // Frequência: a âncora já filtrada (menor atraso) serve de régua, medida em uma base
+    // longa. A origem só é fixada depois de JCLOCK_RATE_SAMPLES, com a fase assentada.
+    const uint64_t span = clk->next - clk->originK;
+    if (clk->originNs == 0) {
+        if (span >= JCLOCK_RATE_SAMPLES) {
+            clk->originK = clk->next;
+            clk->originNs = clk->anchorNs;
+        }
+    } else if (span >= JCLOCK_RATE_SAMPLES) {
+        const int64_t est = (clk->anchorNs - clk->originNs) / (int64_t)span;
+        const int64_t tol = (int64_t)clk->nominalNs * JCLOCK_MAX_PPM / 1000000LL;
+        if (est > (int64_t)clk->nominalNs - tol && est < (int64_t)clk->nominalNs + tol) {
+            clk->periodNs = (uint32_t)est;
+        }
+    }
+
+    const int64_t t0Ns = clk->anchorNs;
+    clk->anchorNs += (int64_t)count * clk->periodNs;
+    clk->next += count;
+    if (seq != NULL) *seq = clk->seq;
+    clk->seq++;
+    return (uint64_t)(t0Ns / 1000LL);
+}
+
+/**
+ * @brief Retorna o período estimado em nanossegundos.
+ */
+uint32_t jclockPeriodNs(const jClock_t *clk) {
+    return clk->periodNs;
+}
+
+#endif
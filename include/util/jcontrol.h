@@ -0,0 +1,348 @@
+/**
+ * @file jcontrol.h
+ * @brief Malhas de controle PID de período fixo executadas por timer de hardware.
+ *
+ * Cada malha registrada possui seu próprio esp_timer periódico, despachado pela tarefa de
+ * alta prioridade do esp_timer, de modo que o período não depende do loop principal.
+ * A cada disparo a malha lê a entrada (função do usuário que deve apenas consultar valores
+ * já adquiridos, como o cache do ADS1115), calcula o PID em ponto fixo e escreve a saída
+ * (por exemplo, LedcOut_c::writeQ16(), que escreve direto no registrador do LEDC).
+ *
+ * PID em ponto fixo:
+ * - ganhos em Q24 (int64, até JCONTROL_GAIN_MAX) e integrador em Q24 (int64), saída em
+ *   Q16 (65536 = 100%); cada produto ganho * erro satura em ±JCONTROL_SAT, muito além da
+ *   faixa da saída, então nenhum ganho aceito estoura a aritmética;
+ * - ação derivativa sobre a medição, com filtro de primeira ordem;
+ * - anti-windup por saturação do integrador nos limites da saída;
+ * - transferência sem solavanco (bumpless) na passagem de manual para automático.
+ *
+ * Para cada malha são mantidos contadores de tempo de execução, jitter do período e
+ * atrasos (overruns).
+ */
+
+#ifndef __JCONTROL_H
+#define __JCONTROL_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#ifndef NUMCONTROLLOOPS
+/**
+ * @brief Número máximo de malhas de controle.
+ */
+#define NUMCONTROLLOOPS 2
+#endif
+
+#ifndef JCONTROL_GAIN_MAX
+/**
+ * @brief Maior ganho aceito por jcontrolTune(), em Q24 (2^40 = 65536 vezes a saída por contagem).
+ */
+#define JCONTROL_GAIN_MAX (1LL << 40)
+#endif
+
+/**
+ * @brief Saturação (Q24) de cada termo do PID: 2^20 vezes a faixa da saída, e pequeno o
+ * bastante para o filtro derivativo (termo * alpha Q16) não estourar 64 bits.
+ */
+#define JCONTROL_SAT (1LL << 44)
+
+/**
+ * @brief Função de entrada: retorna a variável de processo (em contagens do conversor).
+ */
+typedef int32_t (*ControlInput_t)(void);
+
+/**
+ * @brief Função de saída: recebe a saída do controlador em Q16 (0 a 65536).
+ */
+typedef void (*ControlOutput_t)(int32_t outQ16);
+
+/**
+ * @struct ControlStats_t
+ * @brief Contadores de desempenho de uma malha (tempos em microssegundos).
+ */
+typedef struct {
+    uint32_t count;       ///< Execuções desde o último reset.
+    uint32_t overruns;    ///< Execuções que começaram com mais de meio período de atraso.
+    uint32_t execLast;    ///< Tempo da última execução.
+    uint32_t execMin;     ///< Menor tempo de execução.
+    uint32_t execMax;     ///< Maior tempo de execução.
+    uint32_t jitterMax;   ///< Maior desvio entre o intervalo real e o período nominal.
+} ControlStats_t;
+
+/**
+ * @struct ControlGains_t
+ * @brief Ganhos e limites de uma malha em ponto fixo.
+ */
+typedef struct {
+    int64_t kp;                   ///< Ganho proporcional, Q24 (fração da saída por contagem).
+    int64_t ki;                   ///< Ganho integral por amostra (Ki * Ts), Q24.
+    int64_t kd;                   ///< Ganho derivativo por amostra (Kd / Ts), Q24.
+    int32_t alpha;                ///< Coeficiente do filtro derivativo, Q16 (Ts / (Tf + Ts)).
+    int64_t outMin;               ///< Limite inferior da saída, Q24.
+    int64_t outMax;               ///< Limite superior da saída, Q24.
+} ControlGains_t;
+
+/**
+ * @struct ControlLoop_t
+ * @brief Estado de uma malha de controle.
+ *
+ * Os campos de 64 bits são gravados em duas escritas de 32 bits no ESP32; por isso
+ * jcontrolTune() e jcontrolLimits() só escrevem em pending, e jcontrolStep() copia os
+ * valores novos para a malha no início de uma execução, sob _jcontrolMux.
+ */
+typedef struct {
+    ControlInput_t input;         ///< Leitura da variável de processo.
+    ControlOutput_t output;       ///< Escrita da variável manipulada.
+    volatile int32_t setpoint;    ///< Referência (mesma unidade da entrada).
+    int64_t kp;                   ///< Ganho proporcional, Q24 (fração da saída por contagem).
+    int64_t ki;                   ///< Ganho integral por amostra (Ki * Ts), Q24.
+    int64_t kd;                   ///< Ganho derivativo por amostra (Kd / Ts), Q24.
+    int32_t alpha;                ///< Coeficiente do filtro derivativo, Q16 (Ts / (Tf + Ts)).
+    int64_t outMin;               ///< Limite inferior da saída, Q24.
+    int64_t outMax;               ///< Limite superior da saída, Q24.
+    int64_t integ;                ///< Integrador, Q24.
+    int64_t dTerm;                ///< Termo derivativo filtrado, Q24.
+    ControlGains_t pending;       ///< Ganhos e limites a aplicar na próxima execução.
+    volatile bool pendingSet;     ///< true se pending tem valores ainda não aplicados.
+    int32_t prevPv;               ///< Variável de processo da execução anterior.
+    volatile int32_t out;         ///< Última saída, Q16.
+    volatile int32_t manualOut;   ///< Saída em modo manual, Q16.
+    volatile bool automatic;      ///< true em modo automático.
+    bool wasAutomatic;            ///< Modo da execução anterior (para transferência bumpless).
+    uint32_t period;              ///< Período nominal em microssegundos.
+    int64_t lastRun;              ///< Instante (us) da execução anterior.
+    ControlStats_t stats;         ///< Contadores de desempenho.
+    esp_timer_handle_t timer;     ///< Timer periódico da malha.
+} ControlLoop_t;
+
+/**
+ * @brief Índice para rastrear o número de malhas registradas.
+ */
+uint8_t jcontrolIndex = 0;
+
+/**
+ * @brief Array que armazena as malhas de controle.
+ */
+ControlLoop_t jcontrolStruct[NUMCONTROLLOOPS];
+
+/**
+ * @brief Protege ControlLoop_t::pending entre a tarefa do usuário e a do esp_timer.
+ */
+portMUX_TYPE _jcontrolMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Multiplica um ganho Q24 por um erro em contagens, saturando em ±JCONTROL_SAT.
+ */
+inline int64_t IRAM_ATTR _jcontrolMul(int64_t gain, int64_t x) {
+    int64_t r;
+    if (__builtin_mul_overflow(gain, x, &r)) return ((gain < 0) != (x < 0)) ? -JCONTROL_SAT : JCONTROL_SAT;
+    return r > JCONTROL_SAT ? JCONTROL_SAT : (r < -JCONTROL_SAT ? -JCONTROL_SAT : r);
+}
+
+/**
+ * @brief Executa uma iteração do PID em ponto fixo.
+ */
+void IRAM_ATTR jcontrolStep(ControlLoop_t &c) {
+    if (c.pendingSet) {
+        portENTER_CRITICAL(&_jcontrolMux);
+        c.kp = c.pending.kp;
+        c.ki = c.pending.ki;
+        c.kd = c.pending.kd;
+        c.alpha = c.pending.alpha;
+        c.outMin = c.pending.outMin;
+        c.outMax = c.pending.outMax;
+        c.pendingSet = false;
+        portEXIT_CRITICAL(&_jcontrolMux);
+    }
+    const int32_t pv = c.input();
+    if (!c.automatic) {
+        c.out = c.manualOut;
+        c.prevPv = pv;
+        c.dTerm = 0;
+        c.wasAutomatic = false;
+        c.output(c.out);
+        return;
+    }
+    const int64_t err = (int64_t)c.setpoint - pv;
+    const int64_t p = _jcontrolMul(c.kp, err);
+    const int64_t dRaw = -_jcontrolMul(c.kd, (int64_t)pv - c.prevPv);
+    c.dTerm += ((dRaw - c.dTerm) * c.alpha) >> 16;
+    c.prevPv = pv;
+    if (!c.wasAutomatic) {
+        // Bumpless: o integrador assume o valor que mantém a saída onde estava.
+        c.integ = ((int64_t)c.out << 8) - p - c.dTerm;
+        c.wasAutomatic = true;
+    } else {
+        c.integ += _jcontrolMul(c.ki, err);
+    }
+    int64_t u = p + c.integ + c.dTerm;
+    // Anti-windup: o integrador é limitado de forma que a saída não ultrapasse os limites.
+    if (u > c.outMax) {
+        c.integ -= u - c.outMax;
+        u = c.outMax;
+    } else if (u < c.outMin) {
+        c.integ += c.outMin - u;
+        u = c.outMin;
+    }
+    c.out = (int32_t)(u >> 8);
+    c.output(c.out);
+}
+
+/**
+ * @brief Callback do timer: executa a malha e atualiza os contadores.
+ */
+void IRAM_ATTR jcontrolTimer(void *arg) {
+    ControlLoop_t &c = *(ControlLoop_t *)arg;
+    const int64_t start = esp_timer_get_time();
+    if (c.lastRun != 0) {
+        const int32_t interval = (int32_t)(start - c.lastRun);
+        const uint32_t jitter = (uint32_t)abs(interval - (int32_t)c.period);
+        if (jitter > c.stats.jitterMax) c.stats.jitterMax = jitter;
+        if (interval > (int32_t)(c.period + c.period / 2)) c.stats.overruns++;
+    }
+    c.lastRun = start;
+    jcontrolStep(c);
+    const uint32_t exec = (uint32_t)(esp_timer_get_time() - start);
+    c.stats.execLast = exec;
+    if (exec > c.stats.execMax) c.stats.execMax = exec;
+    if (exec < c.stats.execMin) c.stats.execMin = exec;
+    c.stats.count++;
+}
+
+/**
+ * @brief Zera os contadores de desempenho de uma malha.
+ */
+void jcontrolResetStats(uint8_t handle) {
+    if (handle >= jcontrolIndex) return;
+    ControlStats_t &s = jcontrolStruct[handle].stats;
+    memset(&s, 0, sizeof(s));
+    s.execMin = UINT32_MAX;
+}
+
+/**
+ * @brief Ajusta os ganhos do PID (forma paralela, tempo contínuo).
+ *
+ * Os ganhos passam a valer na próxima execução da malha.
+ *
+ * @param handle Malha a ser ajustada.
+ * @param kp Ganho proporcional, em fração da saída por contagem de erro.
+ * @param ki Ganho integral, em fração da saída por contagem por segundo.
+ * @param kd Ganho derivativo, em fração da saída por (contagem/segundo).
+ * @param tf Constante de tempo do filtro derivativo em segundos (0 = sem filtro).
+ * @return false (ganhos anteriores mantidos) se Kp, Ki * Ts ou Kd / Ts passar de
+ * JCONTROL_GAIN_MAX em Q24 ou tf for negativo.
+ */
+bool jcontrolTune(uint8_t handle, float kp, float ki, float kd, float tf = 0.0f) {
+    if (handle >= jcontrolIndex || tf < 0.0f) return false;
+    ControlLoop_t &c = jcontrolStruct[handle];
+    const double ts = c.period * 1e-6;
+    const double q[3] = {kp * 16777216.0, ki * ts * 16777216.0, kd / ts * 16777216.0};
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!(fabs(q[i]) <= (double)JCONTROL_GAIN_MAX)) return false; // Também rejeita NaN.
+    }
+    const int64_t kpQ = llround(q[0]);
+    const int64_t kiQ = llround(q[1]);
+    const int64_t kdQ = llround(q[2]);
+    const int32_t alpha = (int32_t)lroundf(ts / (tf + ts) * 65536.0f);
+    portENTER_CRITICAL(&_jcontrolMux);
+    c.pending.kp = kpQ;
+    c.pending.ki = kiQ;
+    c.pending.kd = kdQ;
+    c.pending.alpha = alpha;
+    c.pendingSet = true;
+    portEXIT_CRITICAL(&_jcontrolMux);
+    return true;
+}
+
+/**
+ * @brief Define os limites da saída (fração de 0.0 a 1.0), aplicados na próxima execução.
+ */
+void jcontrolLimits(uint8_t handle, float outMin, float outMax) {
+    if (handle >= jcontrolIndex) return;
+    ControlLoop_t &c = jcontrolStruct[handle];
+    const int64_t lo = (int64_t)(outMin * 16777216.0f);
+    const int64_t hi = (int64_t)(outMax * 16777216.0f);
+    portENTER_CRITICAL(&_jcontrolMux);
+    c.pending.outMin = lo;
+    c.pending.outMax = hi;
+    c.pendingSet = true;
+    portEXIT_CRITICAL(&_jcontrolMux);
+}
+
+/**
+ * @brief Altera a referência de uma malha.
+ */
+void jcontrolSetpoint(uint8_t handle, int32_t setpoint) {
+    if (handle < jcontrolIndex) jcontrolStruct[handle].setpoint = setpoint;
+}
+
+/**
+ * @brief Coloca a malha em modo manual com a saída indicada (fração de 0.0 a 1.0).
+ */
+void jcontrolManual(uint8_t handle, float out) {
+    if (handle >= jcontrolIndex) return;
+    jcontrolStruct[handle].manualOut = (int32_t)(constrain(out, 0.0f, 1.0f) * 65536.0f);
+    jcontrolStruct[handle].automatic = false;
+}
+
+/**
+ * @brief Coloca a malha em modo automático, sem solavanco na saída.
+ */
+void jcontrolAuto(uint8_t handle) {
+    if (handle < jcontrolIndex) jcontrolStruct[handle].automatic = true;
+}
+
+/**
+ * @brief Retorna a última saída da malha em Q16 (65536 = 100%).
+ */
+int32_t jcontrolOutput(uint8_t handle) {
+    return (handle < jcontrolIndex) ? jcontrolStruct[handle].out : 0;
+}
+
+/**
+ * @brief Retorna os contadores de desempenho da malha.
+ */
+const ControlStats_t *jcontrolStats(uint8_t handle) {
+    return (handle < jcontrolIndex) ? &jcontrolStruct[handle].stats : NULL;
+}
+
+/**
+ * @brief Registra e inicia uma malha de controle.
+ *
+ * A malha começa em modo manual com saída zero, limites de 0 a 100% e ganhos nulos;
+ * ajuste-a com jcontrolTune() e passe para automático com jcontrolAuto().
+ *
+ * @param input Função que retorna a variável de processo.
+ * @param output Função que escreve a saída (Q16).
+ * @param period Período da malha em microssegundos.
+ * @return Endereço (handle) da malha, ou -1 se não houver espaço ou o timer falhar.
+ */
+int8_t jcontrolAttach(ControlInput_t input, ControlOutput_t output, uint32_t period) {
+    if (jcontrolIndex >= NUMCONTROLLOOPS) return -1;
+    ControlLoop_t &c = jcontrolStruct[jcontrolIndex];
+    memset(&c, 0, sizeof(c));
+    c.input = input;
+    c.output = output;
+    c.period = period;
+    c.outMax = 1LL << 24;
+    c.alpha = 65536;
+    c.pending.outMax = c.outMax;
+    c.pending.alpha = c.alpha;
+    c.stats.execMin = UINT32_MAX;
+    esp_timer_create_args_t args = {};
+    args.callback = jcontrolTimer;
+    args.arg = &c;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "jcontrol";
+    if (esp_timer_create(&args, &c.timer) != ESP_OK) return -1;
+    // O índice só avança depois que o timer está rodando: em caso de erro o espaço é reaproveitado.
+    if (esp_timer_start_periodic(c.timer, period) != ESP_OK) {
+        esp_timer_delete(c.timer);
+        c.timer = NULL;
+        return -1;
+    }
+    return jcontrolIndex++;
+}
+
+#endif
@@ -0,0 +1,329 @@
+/**
+ * @file jevent.h
+ * @brief Loop de eventos: o loop principal dorme até haver algo a fazer.
+ *
+ * Em vez de consultar continuamente cada subsistema, o loop bloqueia em um conjunto de
+ * filas do FreeRTOS (queue set) que reúne:
+ * - um semáforo binário sinalizado por jeventSignal()/jeventSignalFromISR(), usado por
+ *   interrupções de GPIO (jeventAttachPin()), timers (jeventTimer()) e pelo onReceive() das UARTs;
+ * - filas de eventos de drivers, como a do I2S (jeventAddQueue()).
+ *
+ * Cada origem acumula bits em uma máscara atômica; ao acordar, jeventWait() entrega os
+ * bits aos handlers registrados com jeventAttach(). Subsistemas que dependem apenas do
+ * tempo (jtask, debounce, varredura do ADS1115) informam o próximo vencimento com
+ * jeventAddDeadline(), e o tempo de espera é o menor deles. Com nada pendente a CPU fica
+ * livre para outras tarefas (e para o idle do FreeRTOS).
+ *
+ * Uso:
+ * @code
+ * DigitalINDebounce push1(def_pin_PUSH1, 50, aoApertar);
+ * void setup() {
+ *     jeventBegin();
+ *     jeventAttachPin(def_pin_PUSH1, JEVENT_GPIO);
+ *     jeventAddDeadline([]() { return push1.nextDue(); });
+ *     jeventAttach(JEVENT_GPIO | JEVENT_TIMEOUT, [](uint32_t) { push1.update(); });
+ * }
+ * void loop() {
+ *     jeventWait();
+ * }
+ * @endcode
+ *
+ * @note jeventWait() deve ser chamada sempre pela mesma tarefa.
+ */
+
+#ifndef __JEVENT_H
+#define __JEVENT_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#define JEVENT_UART    (1UL << 0)  ///< Bytes recebidos na serial de comandos.
+#define JEVENT_ADC     (1UL << 1)  ///< Buffer DMA do I2S completo.
+#define JEVENT_GPIO    (1UL << 2)  ///< Borda em pino registrado com jeventAttachPin().
+#define JEVENT_TIMER   (1UL << 3)  ///< Disparo de timer criado com jeventTimer().
+#define JEVENT_HART    (1UL << 4)  ///< Bytes recebidos do modem HART.
+#define JEVENT_DISPLAY (1UL << 5)  ///< Atualização periódica do display.
+#define JEVENT_USER    (1UL << 8)  ///< Primeiro bit livre para a aplicação.
+#define JEVENT_TIMEOUT (1UL << 31) ///< Acordou por vencimento de prazo (jeventAddDeadline()).
+#define JEVENT_ANY     0xFFFFFFFFUL ///< Máscara que aceita qualquer evento.
+
+#ifndef NUMEVENTHANDLERS
+/**
+ * @brief Número máximo de handlers de eventos.
+ */
+#define NUMEVENTHANDLERS 8
+#endif
+
+#ifndef NUMEVENTDEADLINES
+/**
+ * @brief Número máximo de funções de prazo.
+ */
+#define NUMEVENTDEADLINES 6
+#endif
+
+#ifndef NUMEVENTQUEUES
+/**
+ * @brief Número máximo de filas de drivers no conjunto.
+ */
+#define NUMEVENTQUEUES 2
+#endif
+
+#ifndef JEVENT_SET_LEN
+/**
+ * @brief Capacidade do queue set: 1 (semáforo) + soma dos tamanhos das filas adicionadas.
+ */
+#define JEVENT_SET_LEN 16
+#endif
+
+#ifndef JEVENT_MAX_WAIT_US
+/**
+ * @brief Espera máxima de jeventWait() sem nenhum prazo registrado (us).
+ */
+#define JEVENT_MAX_WAIT_US 1000000UL
+#endif
+
+#define JEVENT_ITEM_MAX 32 ///< Maior item de fila de driver aceito por jeventAddQueue() (bytes).
+
+/**
+ * @brief Handler de eventos: recebe os bits que causaram o despertar.
+ */
+typedef void (*EventHandler_t)(uint32_t bits);
+
+/**
+ * @brief Função de prazo: retorna o tempo (us) até o subsistema ter trabalho, ou UINT32_MAX.
+ */
+typedef uint32_t (*EventDeadline_t)(void);
+
+/**
+ * @struct EventHandlerConfig_t
+ * @brief Handler e a máscara de eventos que o acionam.
+ */
+typedef struct {
+    uint32_t mask;
+    EventHandler_t handler;
+} EventHandlerConfig_t;
+
+/**
+ * @struct EventQueueConfig_t
+ * @brief Fila de driver do conjunto e os bits que ela sinaliza.
+ */
+typedef struct {
+    QueueHandle_t queue;
+    uint32_t bits;
+} EventQueueConfig_t;
+
+EventHandlerConfig_t jeventHandlers[NUMEVENTHANDLERS];
+uint8_t jeventHandlerIndex = 0;
+EventDeadline_t jeventDeadlines[NUMEVENTDEADLINES];
+uint8_t jeventDeadlineIndex = 0;
+EventQueueConfig_t jeventQueues[NUMEVENTQUEUES];
+uint8_t jeventQueueIndex = 0;
+
+/** Conjunto de filas em que o loop bloqueia */
+QueueSetHandle_t _jeventSet = NULL;
+/** Semáforo sinalizado pelas origens de eventos por bits */
+SemaphoreHandle_t _jeventSem = NULL;
+/** Bits pendentes */
+volatile uint32_t _jeventBits = 0;
+/** Protege _jeventBits */
+portMUX_TYPE _jeventMux = portMUX_INITIALIZER_UNLOCKED;
+/** Número de despertares */
+uint32_t _jeventWakeups = 0;
+/** Tempo total bloqueado em jeventWait() (us) */
+uint64_t _jeventIdleUs = 0;
+
+/**
+ * @brief Cria o semáforo e o conjunto de filas. Deve ser chamada antes de registrar origens.
+ * @return true se os objetos do FreeRTOS foram criados.
+ */
+bool jeventBegin(void) {
+    if (_jeventSet != NULL) return true;
+    _jeventSem = xSemaphoreCreateBinary();
+    _jeventSet = xQueueCreateSet(JEVENT_SET_LEN);
+    if (_jeventSem == NULL || _jeventSet == NULL) return false;
+    return xQueueAddToSet(_jeventSem, _jeventSet) == pdPASS;
+}
+
+/**
+ * @brief Sinaliza eventos a partir de uma tarefa (ou callback do esp_timer / onReceive).
+ */
+void jeventSignal(uint32_t bits) {
+    portENTER_CRITICAL(&_jeventMux);
+    _jeventBits |= bits;
+    portEXIT_CRITICAL(&_jeventMux);
+    if (_jeventSem != NULL) xSemaphoreGive(_jeventSem);
+}
+
+/**
+ * @brief Sinaliza eventos a partir de uma ISR.
+ */
+void IRAM_ATTR jeventSignalFromISR(uint32_t bits) {
+    portENTER_CRITICAL_ISR(&_jeventMux);
+    _jeventBits |= bits;
+    portEXIT_CRITICAL_ISR(&_jeventMux);
+    if (_jeventSem == NULL) return;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(_jeventSem, &woken);
+    if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+/**
+ * @brief Registra um handler chamado quando algum dos bits de mask ocorrer.
+ * @return true se havia espaço.
+ */
+bool jeventAttach(uint32_t mask, EventHandler_t handler) {
+    if (jeventHandlerIndex >= NUMEVENTHANDLERS) return false;
+    jeventHandlers[jeventHandlerIndex].mask = mask;
+    jeventHandlers[jeventHandlerIndex].handler = handler;
+    jeventHandlerIndex++;
+    return true;
+}
+
+/**
+ * @brief Registra uma função de prazo consultada antes de cada espera.
+ *
+ * Quando o menor prazo vence, jeventWait() retorna com JEVENT_TIMEOUT.
+ * @return true se havia espaço.
+ */
+bool jeventAddDeadline(EventDeadline_t nextDue) {
+    if (jeventDeadlineIndex >= NUMEVENTDEADLINES) return false;
+    jeventDeadlines[jeventDeadlineIndex++] = nextDue;
+    return true;
+}
+
+/**
+ * @brief Acrescenta a fila de eventos de um driver (por exemplo, do I2S) ao conjunto.
+ *
+ * A fila precisa estar vazia. A cada item recebido, um item é descartado e bits é sinalizado.
+ * @param queue Fila do driver.
+ * @param bits Bits sinalizados quando a fila recebe um item.
+ * @param itemSize Tamanho (bytes) do item da fila, por exemplo sizeof(i2s_event_t).
+ * @return true se a fila foi acrescentada; false se o item for maior que JEVENT_ITEM_MAX.
+ */
+bool jeventAddQueue(QueueHandle_t queue, uint32_t bits, size_t itemSize) {
+    if (_jeventSet == NULL || queue == NULL || jeventQueueIndex >= NUMEVENTQUEUES) return false;
+    if (itemSize > JEVENT_ITEM_MAX) return false; // jeventWait() recebe o item em um buffer fixo.
+    if (xQueueAddToSet(queue, _jeventSet) != pdPASS) return false;
+    jeventQueues[jeventQueueIndex].queue = queue;
+    jeventQueues[jeventQueueIndex].bits = bits;
+    jeventQueueIndex++;
+    return true;
+}
+
+/**
+ * @brief ISR de pino: sinaliza os bits passados como argumento.
+ */
+void IRAM_ATTR jeventPinISR(void *arg) {
+    jeventSignalFromISR((uint32_t)(uintptr_t)arg);
+}
+
+/**
+ * @brief Sinaliza bits a cada borda do pino (interrupção de GPIO).
+ * @param pin Pino monitorado.
+ * @param bits Bits sinalizados.
+ * @param mode RISING, FALLING ou CHANGE (padrão).
+ */
+void jeventAttachPin(uint8_t pin, uint32_t bits, int mode = CHANGE) {
+    attachInterruptArg(digitalPinToInterrupt(pin), jeventPinISR, (void *)(uintptr_t)bits, mode);
+}
+
+/**
+ * @brief Callback de timer: sinaliza os bits passados como argumento.
+ */
+void jeventTimerCallback(void *arg) {
+    jeventSignal((uint32_t)(uintptr_t)arg);
+}
+
+/**
+ * @brief Cria um esp_timer periódico que sinaliza bits.
+ * @param period Período em microssegundos.
+ * @param bits Bits sinalizados a cada disparo.
+ * @return Handle do timer, ou NULL se falhou.
+ */
+esp_timer_handle_t jeventTimer(uint32_t period, uint32_t bits) {
+    esp_timer_create_args_t args = {};
+    args.callback = jeventTimerCallback;
+    args.arg = (void *)(uintptr_t)bits;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "jevent";
+    esp_timer_handle_t timer = NULL;
+    if (esp_timer_create(&args, &timer) != ESP_OK) return NULL;
+    esp_timer_start_periodic(timer, period);
+    return timer;
+}
+
+/**
+ * @brief Retorna o menor prazo entre as funções registradas e maxWait (us).
+ */
+uint32_t jeventNextDue(uint32_t maxWait = JEVENT_MAX_WAIT_US) {
+    uint32_t next = maxWait;
+    for (uint8_t i = 0; i < jeventDeadlineIndex; i++) {
+        const uint32_t due = jeventDeadlines[i]();
+        if (due < next) next = due;
+    }
+    return next;
+}
+
+/**
+ * @brief Bloqueia até um evento ou o próximo prazo e chama os handlers correspondentes.
+ *
+ * A espera é arredondada para baixo em ticks do FreeRTOS; prazos menores que um tick esperam
+ * até o próximo tick (no máximo 1 ms de atraso) em vez de consultar em laço.
+ * @param maxWait Espera máxima em microssegundos.
+ * @return Bits que causaram o despertar (0 se nada ocorreu).
+ */
+uint32_t jeventWait(uint32_t maxWait = JEVENT_MAX_WAIT_US) {
+    if (_jeventSet == NULL) return 0;
+    const uint32_t wait = jeventNextDue(maxWait);
+    TickType_t ticks = (TickType_t)(wait / (1000UL * portTICK_PERIOD_MS));
+    if (ticks == 0 && wait > 0) ticks = 1;
+    const int64_t start = esp_timer_get_time();
+    QueueSetMemberHandle_t member = xQueueSelectFromSet(_jeventSet, ticks);
+    _jeventIdleUs += esp_timer_get_time() - start;
+    uint32_t bits = 0;
+    while (member != NULL) {
+        if (member == _jeventSem) {
+            xSemaphoreTake(_jeventSem, 0);
+        } else {
+            for (uint8_t i = 0; i < jeventQueueIndex; i++) {
+                if (member != jeventQueues[i].queue) continue;
+                uint8_t item[JEVENT_ITEM_MAX];
+                xQueueReceive(jeventQueues[i].queue, item, 0);
+                bits |= jeventQueues[i].bits;
+            }
+        }
+        member = xQueueSelectFromSet(_jeventSet, 0);
+    }
+    portENTER_CRITICAL(&_jeventMux);
+    bits |= _jeventBits;
+    _jeventBits = 0;
+    portEXIT_CRITICAL(&_jeventMux);
+    // Só um prazo vencido conta como TIMEOUT: o fim de maxWait (por exemplo, jeventWait(0)
+    // após o light sleep) não é prazo de nenhum subsistema.
+    if (jeventNextDue(UINT32_MAX) == 0) bits |= JEVENT_TIMEOUT;
+    if (bits == 0) return 0;
+    _jeventWakeups++;
+    for (uint8_t i = 0; i < jeventHandlerIndex; i++) {
+        if (jeventHandlers[i].mask & bits) jeventHandlers[i].handler(bits);
+    }
+    return bits;
+}
+
+/**
+ * @brief Retorna o número de despertares com eventos desde o início.
+ */
+uint32_t jeventWakeups(void) {
+    return _jeventWakeups;
+}
+
+/**
+ * @brief Retorna o tempo total (us) que o loop passou bloqueado em jeventWait().
+ */
+uint64_t jeventIdleUs(void) {
+    return _jeventIdleUs;
+}
+
+#endif
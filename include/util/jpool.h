@@ -0,0 +1,142 @@
+/**
+ * @file jpool.h
+ * @brief Pool de blocos de amostras de tamanho fixo com contagem de referências.
+ *
+ * Os blocos são alocados estaticamente (sem heap) e circulam por ponteiro entre as etapas
+ * da aquisição: o produtor (por exemplo, adcDmaLoop() com adcDmaAttachQueue()) preenche
+ * um bloco e o envia por uma jQueue; cada consumidor processa os dados no próprio bloco
+ * e o repassa adiante ou o devolve com jpoolRelease(). Nenhuma etapa copia as amostras,
+ * e a aquisição não precisa esperar o processamento ou a serial terminarem.
+ *
+ * Para entregar o mesmo bloco a mais de um consumidor, chame jpoolRetain() antes de cada
+ * envio adicional; o bloco volta ao pool quando a última referência é liberada.
+ *
+ * Uso:
+ * @code
+ * jQueue_t filaAdc;
+ * void setup() {
+ *     jQueueInit(&filaAdc);
+ *     adcDmaSetup(ADC1_CHANNEL_0, 1000, NULL, 100000);
+ *     adcDmaAttachQueue(&filaAdc);
+ * }
+ * void loop() {
+ *     adcDmaLoop();
+ *     void *item;
+ *     if (jQueueReceive(&filaAdc, &item)) {
+ *         jBlock_t *b = (jBlock_t *)item;
+ *         IIKit.WSerial.plot("adc", b->t0, b->period, b->data, b->count);
+ *         jpoolRelease(b);
+ *     }
+ * }
+ * @endcode
+ */
+
+#ifndef __JPOOL_H
+#define __JPOOL_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+#ifndef JPOOL_BLOCKS
+/**
+ * @brief Número de blocos do pool (máximo 32).
+ */
+#define JPOOL_BLOCKS 8
+#endif
+
+#ifndef JPOOL_BLOCK_LEN
+/**
+ * @brief Capacidade de cada bloco em amostras.
+ */
+#define JPOOL_BLOCK_LEN 256
+#endif
+
+static_assert(JPOOL_BLOCKS >= 1 && JPOOL_BLOCKS <= 32, "JPOOL_BLOCKS deve estar entre 1 e 32");
+
+/**
+ * @struct jBlock_t
+ * @brief Bloco de amostras com metadados de tempo.
+ */
+typedef struct {
+    int16_t data[JPOOL_BLOCK_LEN]; ///< Amostras.
+    uint16_t count;                ///< Número de amostras válidas.
+    uint8_t channel;               ///< Canal de origem.
+    volatile uint8_t refs;         ///< Referências ativas (0 = livre).
+    uint32_t period;               ///< Período de amostragem em microssegundos.
+    uint32_t seq;                  ///< Número de sequência do bloco na origem (lacunas = blocos perdidos).
+    uint64_t t0;                   ///< Instante (us, esp_timer) da primeira amostra.
+} jBlock_t;
+
+/**
+ * @brief Blocos do pool.
+ */
+__attribute__((aligned(16))) jBlock_t jpoolBlocks[JPOOL_BLOCKS];
+
+/** Mapa de blocos livres (bit i = bloco i livre) */
+uint32_t _jpoolFree = (JPOOL_BLOCKS == 32) ? 0xFFFFFFFFUL : ((1UL << JPOOL_BLOCKS) - 1);
+/** Alocações que falharam por falta de bloco */
+uint32_t _jpoolMisses = 0;
+/** Protege o mapa e as referências entre tarefas, núcleos e ISRs */
+portMUX_TYPE _jpoolMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Retira um bloco livre do pool, com uma referência.
+ *
+ * @return Ponteiro para o bloco, ou NULL se todos estiverem em uso.
+ */
+jBlock_t *IRAM_ATTR jpoolAlloc(void) {
+    portENTER_CRITICAL_ISR(&_jpoolMux);
+    if (_jpoolFree == 0) {
+        _jpoolMisses++;
+        portEXIT_CRITICAL_ISR(&_jpoolMux);
+        return NULL;
+    }
+    const uint8_t i = __builtin_ctz(_jpoolFree);
+    _jpoolFree &= ~(1UL << i);
+    jBlock_t *b = &jpoolBlocks[i];
+    b->refs = 1;
+    portEXIT_CRITICAL_ISR(&_jpoolMux);
+    b->count = 0;
+    b->channel = 0;
+    b->period = 0;
+    b->seq = 0;
+    b->t0 = 0;
+    return b;
+}
+
+/**
+ * @brief Acrescenta uma referência ao bloco (antes de entregá-lo a mais um consumidor).
+ */
+void IRAM_ATTR jpoolRetain(jBlock_t *b) {
+    portENTER_CRITICAL_ISR(&_jpoolMux);
+    b->refs++;
+    portEXIT_CRITICAL_ISR(&_jpoolMux);
+}
+
+/**
+ * @brief Libera uma referência; o bloco volta ao pool quando não houver mais nenhuma.
+ */
+void IRAM_ATTR jpoolRelease(jBlock_t *b) {
+    if (b == NULL) return;
+    portENTER_CRITICAL_ISR(&_jpoolMux);
+    if (b->refs > 0 && --b->refs == 0) {
+        _jpoolFree |= 1UL << (uint8_t)(b - jpoolBlocks);
+    }
+    portEXIT_CRITICAL_ISR(&_jpoolMux);
+}
+
+/**
+ * @brief Retorna o número de blocos livres.
+ */
+uint8_t jpoolAvailable(void) {
+    return __builtin_popcount(_jpoolFree);
+}
+
+/**
+ * @brief Retorna quantas alocações falharam por falta de bloco.
+ */
+uint32_t jpoolMisses(void) {
+    return _jpoolMisses;
+}
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file jprof.h
+ * @brief Instrumentação leve de trechos críticos com o contador de ciclos (CCOUNT) do Xtensa.
+ *
+ * Cada ponto de medição (probe) acumula número de execuções, mínimo, máximo, soma e um
+ * histograma logarítmico de tamanho fixo (2 faixas por oitava), de onde é estimado o
+ * percentil 99. Também é medida a frequência do loop principal e contados os loops que
+ * excederam o orçamento de tempo.
+ *
+ * Uso:
+ * @code
+ * void loop() {
+ *     JPROF_LOOP(1000);              // Orçamento de 1000 us por iteração.
+ *     {
+ *         JPROF_SCOPE("filtro");     // Mede até o fim do bloco.
+ *         filtrar();
+ *     }
+ * }
+ * @endcode
+ *
+ * Sem IIKIT_PROFILE definido as macros não geram código, então os probes podem ficar
+ * no firmware de produção. O comando de serial "prof" lista os probes e "prof reset" zera.
+ */
+
+#ifndef __JPROF_H
+#define __JPROF_H
+
+#include <Arduino.h>
+
+#ifdef IIKIT_PROFILE
+
+#include <xtensa/hal.h>
+
+#ifndef NUMPROBES
+/**
+ * @brief Número máximo de probes.
+ */
+#define NUMPROBES 8
+#endif
+
+#define JPROF_BUCKETS 64 ///< Faixas do histograma: 32 oitavas x 2.
+
+/**
+ * @struct JProbe_t
+ * @brief Estatísticas de um probe (tempos em ciclos de CPU).
+ */
+typedef struct {
+    const char *name;                 ///< Nome exibido no relatório.
+    uint32_t count;                   ///< Número de medições.
+    uint32_t min;                     ///< Menor duração.
+    uint32_t max;                     ///< Maior duração.
+    uint64_t sum;                     ///< Soma das durações.
+    uint32_t hist[JPROF_BUCKETS];     ///< Histograma logarítmico das durações.
+} JProbe_t;
+
+/**
+ * @brief Probes registrados.
+ */
+JProbe_t jprofStruct[NUMPROBES];
+/**
+ * @brief Índice para rastrear o número de probes registrados.
+ */
+uint8_t jprofIndex = 0;
+
+/** Estatísticas do loop principal */
+uint32_t _jprofLoopLast = 0;       ///< CCOUNT do início da iteração anterior.
+uint32_t _jprofLoopCount = 0;      ///< Iterações medidas.
+uint32_t _jprofLoopOverruns = 0;   ///< Iterações acima do orçamento.
+uint64_t _jprofLoopSum = 0;        ///< Soma dos períodos (ciclos).
+uint32_t _jprofLoopMax = 0;        ///< Maior período (ciclos).
+
+/**
+ * @brief Registra um probe e retorna seu índice (ou NUMPROBES se não houver espaço).
+ */
+uint8_t jprofRegister(const char *name) {
+    if (jprofIndex >= NUMPROBES) return NUMPROBES;
+    JProbe_t &p = jprofStruct[jprofIndex];
+    memset(&p, 0, sizeof(p));
+    p.name = name;
+    p.min = UINT32_MAX;
+    return jprofIndex++;
+}
+
+/**
+ * @brief Faixa do histograma para uma duração: 2 faixas por potência de 2.
+ */
+inline uint8_t jprofBucket(uint32_t cycles) {
+    if (cycles < 2) return 0;
+    const uint8_t msb = 31 - __builtin_clz(cycles);
+    return (msb << 1) | ((cycles >> (msb - 1)) & 1);
+}
+
+/**
+ * @brief Limite superior (em ciclos) de uma faixa do histograma.
+ */
+inline uint32_t jprofBucketTop(uint8_t bucket) {
+    const uint8_t msb = bucket >> 1;
+    const uint64_t top = (bucket & 1) ? (2ULL << msb) : (3ULL << msb) / 2;
+    return top > UINT32_MAX ? UINT32_MAX : (uint32_t)top;
+}
+
+/**
+ * @brief Acumula uma medição no probe.
+ */
+inline void IRAM_ATTR jprofRecord(uint8_t id, uint32_t cycles) {
+    if (id >= NUMPROBES) return;
+    JProbe_t &p = jprofStruct[id];
+    p.count++;
+    p.sum += cycles;
+    if (cycles < p.min) p.min = cycles;
+    if (cycles > p.max) p.max = cycles;
+    p.hist[jprofBucket(cycles)]++;
+}
+
+/**
+ * @class JProfScope
+ * @brief Mede o tempo entre a construção e a destruição (fim do escopo).
+ */
+class JProfScope {
+public:
+    inline JProfScope(uint8_t id) : _id(id), _start(xthal_get_ccount()) {}
+    inline ~JProfScope() { jprofRecord(_id, xthal_get_ccount() - _start); }
+
+private:
+    uint8_t _id;
+    uint32_t _start;
+};
+
+/**
+ * @brief Marca o início de uma iteração do loop principal.
+ * @param budgetUs Orçamento de tempo por iteração em microssegundos.
+ */
+inline void jprofLoop(uint32_t budgetUs) {
+    const uint32_t now = xthal_get_ccount();
+    if (_jprofLoopLast != 0) {
+        const uint32_t period = now - _jprofLoopLast;
+        _jprofLoopCount++;
+        _jprofLoopSum += period;
+        if (period > _jprofLoopMax) _jprofLoopMax = period;
+        if (period > budgetUs * getCpuFrequencyMhz()) _jprofLoopOverruns++;
+    }
+    _jprofLoopLast = now;
+}
+
+/**
+ * @brief Zera todas as estatísticas, mantendo os probes registrados.
+ */
+void jprofReset(void) {
+    for (uint8_t i = 0; i < jprofIndex; i++) {
+        const char *name = jprofStruct[i].name;
+        memset(&jprofStruct[i], 0, sizeof(JProbe_t));
+        jprofStruct[i].name = name;
+        jprofStruct[i].min = UINT32_MAX;
+    }
+    _jprofLoopLast = 0;
+    _jprofLoopCount = 0;
+    _jprofLoopOverruns = 0;
+    _jprofLoopSum = 0;
+    _jprofLoopMax = 0;
+}
+
+/**
+ * @brief Estima o percentil 99 de um probe (em ciclos) pelo histograma.
+ */
+uint32_t jprofP99(const JProbe_t &p) {
+    const uint32_t target = p.count - p.count / 100;
+    uint32_t acc = 0;
+    for (uint8_t b = 0; b < JPROF_BUCKETS; b++) {
+        acc += p.hist[b];
+        if (acc >= target) return min(jprofBucketTop(b), p.max);
+    }
+    return p.max;
+}
+
+/**
+ * @brief Trata o comando "prof" recebido pela serial.
+ *
+ * Uma linha por probe: "nome n=... min=... avg=... p99=... max=..." (tempos em us) e uma
+ * linha "loop" com a frequência média, o maior período e os estouros de orçamento.
+ * @param out Saída para as respostas (por exemplo, IIKit.WSerial).
+ * @param args "reset" para zerar as estatísticas.
+ */
+template <typename S>
+void jprofCommand(S &out, String args) {
+    args.trim();
+    if (args == "reset") {
+        jprofReset();
+        out.println("prof: reset");
+        return;
+    }
+    const float mhz = getCpuFrequencyMhz();
+    for (uint8_t i = 0; i < jprofIndex; i++) {
+        const JProbe_t &p = jprofStruct[i];
+        if (p.count == 0) continue;
+        out.print(p.name);
+        out.print(" n=");
+        out.print(p.count);
+        out.print(" min=");
+        out.print(p.min / mhz);
+        out.print(" avg=");
+        out.print((float)(p.sum / p.count) / mhz);
+        out.print(" p99=");
+        out.print(jprofP99(p) / mhz);
+        out.print(" max=");
+        out.println(p.max / mhz);
+    }
+    if (_jprofLoopCount > 0) {
+        out.print("loop hz=");
+        out.print(mhz * 1e6f * _jprofLoopCount / (float)_jprofLoopSum);
+        out.print(" max=");
+        out.print(_jprofLoopMax / mhz);
+        out.print(" overruns=");
+        out.println(_jprofLoopOverruns);
+    }
+}
+
+#define JPROF_CAT2(a, b) a##b
+#define JPROF_CAT(a, b) JPROF_CAT2(a, b)
+/**
+ * @brief Mede o tempo até o fim do escopo corrente, acumulando no probe name.
+ */
+#define JPROF_SCOPE(name)                                              \
+    static const uint8_t JPROF_CAT(_jprofId, __LINE__) = jprofRegister(name); \
+    JProfScope JPROF_CAT(_jprofScope, __LINE__)(JPROF_CAT(_jprofId, __LINE__))
+/**
+ * @brief Marca o início de uma iteração do loop com orçamento de budgetUs microssegundos.
+ */
+#define JPROF_LOOP(budgetUs) jprofLoop(budgetUs)
+
+#else
+
+#define JPROF_SCOPE(name)
+#define JPROF_LOOP(budgetUs)
+
+#endif // IIKIT_PROFILE
+
+#endif
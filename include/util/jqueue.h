@@ -4,6 +4,9 @@
  *
  * Este arquivo implementa uma estrutura de fila genérica com suporte a diferentes tipos de dados,
  * permitindo o uso em ambientes com interrupções, como ISRs (Interrupt Service Routines).
+ *
+ * As operações que alteram a fila são protegidas por seção crítica, então produtor e
+ * consumidor podem estar em tarefas, núcleos ou ISRs diferentes.
  */
 
 #ifndef __JQUEUE_H
@@ -11,6 +14,7 @@
 
 #include <Arduino.h>
 #include <stdlib.h>
+#include <freertos/FreeRTOS.h>
 
 #ifndef MAXLENGTHJQUEUE
 /**
@@ -30,6 +34,9 @@ typedef struct {
     uint8_t count; ///< Número atual de itens na fila.
 } jQueue_t;
 
+/** Protege head, tail e count de todas as filas */
+portMUX_TYPE _jQueueMux = portMUX_INITIALIZER_UNLOCKED;
+
 /**
  * @brief Inicializa uma fila genérica.
  *
@@ -49,12 +56,15 @@ void jQueueInit(jQueue_t *queue) {
  * @return true se o item foi adicionado com sucesso, false caso a fila esteja cheia.
  */
 bool jQueueSendFromISR(jQueue_t *queue, void *item) {
-    if (queue->count == MAXLENGTHJQUEUE) return false; // Verifica se a fila está cheia.
-    //noInterrupts();
+    portENTER_CRITICAL_ISR(&_jQueueMux);
+    if (queue->count == MAXLENGTHJQUEUE) { // Verifica se a fila está cheia.
+        portEXIT_CRITICAL_ISR(&_jQueueMux);
+        return false;
+    }
     queue->buffer[queue->tail] = item;
     queue->tail = (queue->tail + 1) % MAXLENGTHJQUEUE;
     queue->count++;
-    //interrupts();
+    portEXIT_CRITICAL_ISR(&_jQueueMux);
     return true;
 }
 
@@ -66,12 +76,15 @@ bool jQueueSendFromISR(jQueue_t *queue, void *item) {
  * @return true se o item foi removido com sucesso, false caso a fila esteja vazia.
  */
 bool jQueueReceive(jQueue_t *queue, void **item) {
-    if (queue->count == 0) return false; // Verifica se a fila está vazia.
-    //noInterrupts();
+    portENTER_CRITICAL(&_jQueueMux);
+    if (queue->count == 0) { // Verifica se a fila está vazia.
+        portEXIT_CRITICAL(&_jQueueMux);
+        return false;
+    }
     *item = queue->buffer[queue->head];
     queue->head = (queue->head + 1) % MAXLENGTHJQUEUE;
     queue->count--;
-    //interrupts();
+    portEXIT_CRITICAL(&_jQueueMux);
     return true;
 }
 
@@ -0,0 +1,286 @@
+/**
+ * @file jsleep.h
+ * @brief Modo de baixo consumo: dorme em light sleep até o próximo prazo.
+ *
+ * A cada chamada de jsleepLoop() é calculado o próximo vencimento entre os prazos do loop
+ * de eventos (jeventAddDeadline(), por exemplo a varredura do ADS1115), as tarefas do
+ * jtask, os AsyncDelay_c registrados e o próximo alarme do esp_timer (malhas do jcontrol,
+ * timers do jevent). Se houver tempo suficiente, o chip entra em light sleep e acorda pelo
+ * timer, por mudança de nível em um pino registrado ou por dados na UART; caso contrário,
+ * espera normalmente em jeventWait(). Depois de acordar, os handlers do jevent são chamados.
+ *
+ * Durante rajadas de aquisição (jsleepBurstBegin() / jsleepBurstEnd()) o chip não dorme e,
+ * se configurado com jsleepClocks(), a CPU sobe para o clock de rajada.
+ *
+ * Exemplo de registrador a 1 Hz:
+ * @code
+ * AsyncDelay_c logTimer(1000);
+ * void setup() {
+ *     jeventBegin();
+ *     jsleepAddDelay(&logTimer);
+ *     jsleepWakeUart(0);
+ *     jsleepClocks(80, 240);
+ * }
+ * void loop() {
+ *     jsleepLoop();
+ *     if (logTimer.isExpired()) {
+ *         jsleepBurstBegin();
+ *         registrar();
+ *         jsleepBurstEnd();
+ *     }
+ * }
+ * @endcode
+ *
+ * @note Em light sleep os periféricos internos param: o I2S/DMA (AdcDmaEsp.h) não adquire
+ * e o LEDC em alta velocidade, com clock do APB, congela a saída no nível do instante em que
+ * o chip dormiu. Por isso o chip não dorme enquanto algum LedcOut_c tiver duty diferente de
+ * zero (LedcOut_c::anyActive()), como a saída 4-20mA. A varredura do ADS1115 a 860 SPS impede
+ * o sono (prazo de ~1,2 ms); para registro lento use startScan(RATE_ADS1115_8SPS). Os
+ * primeiros caracteres recebidos pela UART apenas acordam o chip e são perdidos.
+ */
+
+#ifndef __JSLEEP_H
+#define __JSLEEP_H
+
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
+#include "jevent.h"
+#include "jtask.h"
+#include "asyncDelay.h"
+#include "ledcOut.h"
+
+#ifndef JSLEEP_MIN_US
+/**
+ * @brief Menor espera (us) que vale a entrada em light sleep.
+ */
+#define JSLEEP_MIN_US 3000UL
+#endif
+
+#ifndef JSLEEP_GUARD_US
+/**
+ * @brief Antecipação (us) do despertar, para cobrir o tempo de saída do light sleep.
+ */
+#define JSLEEP_GUARD_US 1000UL
+#endif
+
+#ifndef NUMSLEEPDELAYS
+/**
+ * @brief Número máximo de AsyncDelay_c consultados.
+ */
+#define NUMSLEEPDELAYS 4
+#endif
+
+#ifndef NUMSLEEPPINS
+/**
+ * @brief Número máximo de pinos de despertar.
+ */
+#define NUMSLEEPPINS 4
+#endif
+
+AsyncDelay_c *jsleepDelays[NUMSLEEPDELAYS];
+uint8_t jsleepDelayIndex = 0;
+uint8_t jsleepPins[NUMSLEEPPINS];
+uint8_t jsleepPinModes[NUMSLEEPPINS]; ///< Modo da interrupção do pino, restaurado ao acordar.
+uint8_t jsleepPinIndex = 0;
+
+/** Rajadas em andamento (o chip não dorme enquanto > 0) */
+volatile uint8_t _jsleepBurst = 0;
+/** Clock da CPU fora das rajadas (0 = não altera) */
+uint32_t _jsleepIdleMhz = 0;
+/** Clock da CPU durante as rajadas (0 = não altera) */
+uint32_t _jsleepBurstMhz = 0;
+
+/** Estatísticas */
+bool _jsleepStarted = false;     ///< true após a primeira chamada de jsleepLoop() ou jsleepReset().
+int64_t _jsleepStart = 0;        ///< Instante (us) da primeira chamada de jsleepLoop().
+uint64_t _jsleepAsleepUs = 0;    ///< Tempo total em light sleep (us).
+uint32_t _jsleepCount = 0;       ///< Entradas em light sleep.
+uint32_t _jsleepWakeTimer = 0;   ///< Despertares pelo timer.
+uint32_t _jsleepWakeGpio = 0;    ///< Despertares por pino.
+uint32_t _jsleepWakeUart = 0;    ///< Despertares pela UART.
+
+/**
+ * @brief Registra um AsyncDelay_c cuja expiração deve acordar o chip.
+ * @return true se havia espaço.
+ */
+bool jsleepAddDelay(AsyncDelay_c *delay) {
+    if (jsleepDelayIndex >= NUMSLEEPDELAYS) return false;
+    jsleepDelays[jsleepDelayIndex++] = delay;
+    return true;
+}
+
+/**
+ * @brief Registra um pino cuja mudança de nível acorda o chip (sinaliza JEVENT_GPIO).
+ *
+ * O despertar usa interrupção por nível; ao acordar, o tipo de interrupção do pino volta
+ * a mode, o mesmo passado a jeventAttachPin().
+ * @param pin Pino monitorado.
+ * @param mode RISING, FALLING ou CHANGE (padrão).
+ * @return true se havia espaço.
+ */
+bool jsleepWakePin(uint8_t pin, int mode = CHANGE) {
+    if (jsleepPinIndex >= NUMSLEEPPINS) return false;
+    jsleepPins[jsleepPinIndex] = pin;
+    jsleepPinModes[jsleepPinIndex] = mode;
+    jsleepPinIndex++;
+    return true;
+}
+
+/**
+ * @brief Habilita o despertar pela recepção na UART (sinaliza JEVENT_UART).
+ * @param uart Número da UART (0 = Serial).
+ * @param threshold Bordas de subida no RX necessárias para acordar (padrão: 3).
+ */
+void jsleepWakeUart(uint8_t uart = 0, int threshold = 3) {
+    uart_set_wakeup_threshold((uart_port_t)uart, threshold);
+    esp_sleep_enable_uart_wakeup(uart);
+}
+
+/**
+ * @brief Define os clocks da CPU fora e durante as rajadas (MHz: 80, 160 ou 240).
+ *
+ * Valores abaixo de 80 MHz não são aceitos porque alteram o clock do APB (UART, LEDC, I2C).
+ */
+void jsleepClocks(uint32_t idleMhz, uint32_t burstMhz) {
+    _jsleepIdleMhz = idleMhz >= 80 ? idleMhz : 0;
+    _jsleepBurstMhz = burstMhz >= 80 ? burstMhz : 0;
+    if (_jsleepIdleMhz != 0 && _jsleepBurst == 0) setCpuFrequencyMhz(_jsleepIdleMhz);
+}
+
+/**
+ * @brief Início de uma rajada: impede o sono e sobe o clock da CPU.
+ */
+void jsleepBurstBegin(void) {
+    if (_jsleepBurst++ == 0 && _jsleepBurstMhz != 0) setCpuFrequencyMhz(_jsleepBurstMhz);
+}
+
+/**
+ * @brief Fim de uma rajada: libera o sono e volta ao clock de repouso.
+ */
+void jsleepBurstEnd(void) {
+    if (_jsleepBurst == 0) return;
+    if (--_jsleepBurst == 0 && _jsleepIdleMhz != 0) setCpuFrequencyMhz(_jsleepIdleMhz);
+}
+
+/**
+ * @brief Retorna o tempo (us) até o próximo vencimento entre todas as origens, limitado a maxWait.
+ */
+uint32_t jsleepNextDue(uint32_t maxWait = JEVENT_MAX_WAIT_US) {
+    uint32_t next = jeventNextDue(maxWait);
+    const uint32_t task = jtaskNextDue();
+    if (task < next) next = task;
+    for (uint8_t i = 0; i < jsleepDelayIndex; i++) {
+        const uint32_t ms = jsleepDelays[i]->remaining();
+        const uint32_t us = (ms < UINT32_MAX / 1000UL) ? ms * 1000UL : UINT32_MAX;
+        if (us < next) next = us;
+    }
+    const int64_t alarm = esp_timer_get_next_alarm() - esp_timer_get_time();
+    if (alarm < (int64_t)next) next = alarm > 0 ? (uint32_t)alarm : 0;
+    return next;
+}
+
+void jsleepReset(void);
+
+/**
+ * @brief Dorme em light sleep até o próximo vencimento (ou evento) e chama os handlers do jevent.
+ *
+ * Se o próximo vencimento estiver a menos de JSLEEP_MIN_US, houver uma rajada em
+ * andamento ou uma saída do LEDC ativa, apenas espera em jeventWait().
+ * @param maxWait Espera máxima em microssegundos.
+ * @return Bits dos eventos tratados (ver jeventWait()).
+ */
+uint32_t jsleepLoop(uint32_t maxWait = JEVENT_MAX_WAIT_US) {
+    if (!_jsleepStarted) jsleepReset();
+    const uint32_t next = jsleepNextDue(maxWait);
+    if (_jsleepBurst > 0 || next < JSLEEP_MIN_US || LedcOut_c::anyActive()) return jeventWait(next);
+
+    for (uint8_t i = 0; i < jsleepPinIndex; i++) {
+        // Só há despertar por nível: espera o nível oposto ao atual.
+        gpio_wakeup_enable((gpio_num_t)jsleepPins[i], digitalRead(jsleepPins[i]) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    }
+    if (jsleepPinIndex > 0) esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_timer_wakeup(next - JSLEEP_GUARD_US);
+    Serial.flush(); // A UART para em light sleep: termina a transmissão antes.
+
+    const int64_t start = esp_timer_get_time();
+    esp_light_sleep_start();
+    _jsleepAsleepUs += esp_timer_get_time() - start;
+    _jsleepCount++;
+
+    for (uint8_t i = 0; i < jsleepPinIndex; i++) {
+        gpio_wakeup_disable((gpio_num_t)jsleepPins[i]);
+        // gpio_wakeup_enable() trocou o tipo de interrupção para nível; os modos do Arduino
+        // (RISING, FALLING, CHANGE) têm os mesmos valores de gpio_int_type_t.
+        gpio_set_intr_type((gpio_num_t)jsleepPins[i], (gpio_int_type_t)(jsleepPinModes[i] & 7));
+    }
+    switch (esp_sleep_get_wakeup_cause()) {
+    case ESP_SLEEP_WAKEUP_GPIO:
+        _jsleepWakeGpio++;
+        jeventSignal(JEVENT_GPIO); // A borda ocorreu com o GPIO parado: a ISR não dispara.
+        break;
+    case ESP_SLEEP_WAKEUP_UART:
+        _jsleepWakeUart++;
+        jeventSignal(JEVENT_UART);
+        break;
+    default:
+        _jsleepWakeTimer++;
+        break;
+    }
+    return jeventWait(0);
+}
+
+/**
+ * @brief Retorna a fração do tempo acordado desde a primeira chamada de jsleepLoop() (0.0 a 1.0).
+ */
+float jsleepDutyCycle(void) {
+    const int64_t elapsed = esp_timer_get_time() - _jsleepStart;
+    if (!_jsleepStarted || elapsed <= 0) return 1.0f;
+    return 1.0f - (float)_jsleepAsleepUs / (float)elapsed;
+}
+
+/**
+ * @brief Zera as estatísticas de sono.
+ */
+void jsleepReset(void) {
+    _jsleepStarted = true;
+    _jsleepStart = esp_timer_get_time();
+    _jsleepAsleepUs = 0;
+    _jsleepCount = 0;
+    _jsleepWakeTimer = 0;
+    _jsleepWakeGpio = 0;
+    _jsleepWakeUart = 0;
+}
+
+/**
+ * @brief Trata o comando "sleep" recebido pela serial.
+ *
+ * Responde "sleep duty=... n=... avg=... timer=... gpio=... uart=..." (duty em %, avg em us).
+ * @param out Saída para as respostas (por exemplo, IIKit.WSerial).
+ * @param args "reset" para zerar as estatísticas.
+ */
+template <typename S>
+void jsleepCommand(S &out, String args) {
+    args.trim();
+    if (args == "reset") {
+        jsleepReset();
+        out.println("sleep: reset");
+        return;
+    }
+    out.print("sleep duty=");
+    out.print(jsleepDutyCycle() * 100.0f);
+    out.print(" n=");
+    out.print(_jsleepCount);
+    out.print(" avg=");
+    out.print(_jsleepCount ? (uint32_t)(_jsleepAsleepUs / _jsleepCount) : 0);
+    out.print(" timer=");
+    out.print(_jsleepWakeTimer);
+    out.print(" gpio=");
+    out.print(_jsleepWakeGpio);
+    out.print(" uart=");
+    out.println(_jsleepWakeUart);
+}
+
+#endif
@@ -0,0 +1,316 @@
+/**
+ * @file jstats.h
+ * @brief Estatísticas por janela (mínimo, máximo, média, RMS, desvio padrão) de fluxos de amostras.
+ *
+ * Em vez de enviar as amostras brutas (WSerialmini_c::plot()), cada canal acumula as
+ * estatísticas de uma janela de tempo e entrega um único resumo (JStatsSummary_t) ao
+ * final dela, por callback.
+ *
+ * Cada bloco é reduzido em um laço inteiro sem desvios (soma, soma dos quadrados, mínimo e
+ * máximo, exatos em 32/64 bits) e combinado à janela pela fórmula de Chan para a variância
+ * (Welford em blocos), de modo que o ponto flutuante é usado uma vez por bloco e não por
+ * amostra, sem o cancelamento numérico de sumsq - sum^2/n em janelas longas.
+ *
+ * Com JSTATS_BINS > 0 cada canal mantém também um histograma linear da faixa informada em
+ * jstatsAdd(), de onde saem os percentis 50, 90 e 99 do resumo. A resolução dos percentis
+ * é a largura de uma faixa ((hi - lo) / JSTATS_BINS): dentro da faixa as amostras são
+ * supostas uniformes entre os limites dela, recortados pelo mínimo e máximo da janela. Um
+ * sinal que ocupa poucas faixas tem percentis tão bons quanto essa suposição; para mais
+ * resolução, estreite a faixa de jstatsAdd() ou aumente JSTATS_BINS.
+ *
+ * A janela é fechada no primeiro bloco que termina depois do fim dela: a resolução da
+ * janela é de um bloco.
+ *
+ * Uso:
+ * @code
+ * void resumo(uint8_t channel, const JStatsSummary_t &s) { jstatsPrint(IIKit.WSerial, channel, s); }
+ * void setup() {
+ *     jstatsAdd(0, 10000, resumo);               // Janelas de 10 s no canal 0.
+ * }
+ * void loop() {
+ *     void *item;
+ *     if (jQueueReceive(&filaAdc, &item)) {
+ *         jstatsBlock((jBlock_t *)item);
+ *         jpoolRelease((jBlock_t *)item);
+ *     }
+ * }
+ * @endcode
+ */
+
+#ifndef __JSTATS_H
+#define __JSTATS_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "jpool.h"
+
+#ifndef NUMSTATS
+/**
+ * @brief Número máximo de canais acompanhados.
+ */
+#define NUMSTATS 4
+#endif
+
+#ifndef JSTATS_BINS
+/**
+ * @brief Faixas do histograma de percentis por canal (0 desabilita).
+ */
+#define JSTATS_BINS 32
+#endif
+
+/**
+ * @struct JStatsSummary_t
+ * @brief Resumo de uma janela.
+ */
+typedef struct {
+    uint64_t t0;       ///< Instante (us) da primeira amostra da janela.
+    uint32_t span;     ///< Duração (us) coberta pelas amostras.
+    uint32_t count;    ///< Número de amostras.
+    int16_t min;       ///< Menor amostra.
+    int16_t max;       ///< Maior amostra.
+    float mean;        ///< Média.
+    float rms;         ///< Valor eficaz.
+    float std;         ///< Desvio padrão amostral.
+#if JSTATS_BINS > 0
+    int16_t p50;       ///< Mediana estimada.
+    int16_t p90;       ///< Percentil 90 estimado.
+    int16_t p99;       ///< Percentil 99 estimado.
+#endif
+} JStatsSummary_t;
+
+/**
+ * @brief Recebe o resumo de cada janela fechada.
+ */
+typedef void (*CallbackStats)(uint8_t channel, const JStatsSummary_t &summary);
+
+/**
+ * @struct JStats_t
+ * @brief Acumuladores da janela em andamento de um canal.
+ */
+typedef struct {
+    uint8_t channel;        ///< Canal acompanhado.
+    uint32_t window;        ///< Duração da janela (us).
+    CallbackStats callback; ///< Destino dos resumos.
+    uint64_t t0;            ///< Início (us) da janela.
+    uint64_t tEnd;          ///< Fim (us) da última amostra acumulada.
+    uint32_t n;             ///< Amostras na janela.
+    double mean;            ///< Média corrente.
+    double m2;              ///< Soma dos quadrados dos desvios (Welford).
+    uint64_t sumSq;         ///< Soma exata dos quadrados (RMS).
+    int16_t min;            ///< Menor amostra.
+    int16_t max;            ///< Maior amostra.
+#if JSTATS_BINS > 0
+    int16_t lo;             ///< Início da faixa do histograma.
+    uint16_t binWidth;      ///< Largura de cada faixa (contagens).
+    uint32_t hist[JSTATS_BINS]; ///< Histograma da janela.
+#endif
+} JStats_t;
+
+/**
+ * @brief Canais acompanhados.
+ */
+JStats_t jstatsStruct[NUMSTATS];
+/**
+ * @brief Número de canais registrados.
+ */
+uint8_t jstatsIndex = 0;
+
+/**
+ * @brief Zera os acumuladores de um canal.
+ */
+void _jstatsClear(JStats_t &s) {
+    s.t0 = 0;
+    s.tEnd = 0;
+    s.n = 0;
+    s.mean = 0.0;
+    s.m2 = 0.0;
+    s.sumSq = 0;
+    s.min = INT16_MAX;
+    s.max = INT16_MIN;
+#if JSTATS_BINS > 0
+    memset(s.hist, 0, sizeof(s.hist));
+#endif
+}
+
+/**
+ * @brief Acompanha um canal.
+ * @param channel Canal (jBlock_t::channel ou o informado a jstatsUpdate()).
+ * @param windowMs Duração de cada janela em milissegundos.
+ * @param callback Função que recebe cada resumo.
+ * @param lo Início da faixa do histograma de percentis (padrão: 0).
+ * @param hi Fim da faixa do histograma (padrão: 4095, o ADC de 12 bits).
+ * @return Índice do canal, ou -1 se a tabela estiver cheia.
+ */
+int8_t jstatsAdd(uint8_t channel, uint32_t windowMs, CallbackStats callback, int16_t lo = 0, int16_t hi = 4095) {
+    if (jstatsIndex >= NUMSTATS) return -1;
+    JStats_t &s = jstatsStruct[jstatsIndex];
+    s.channel = channel;
+    s.window = windowMs * 1000UL;
+    s.callback = callback;
+#if JSTATS_BINS > 0
+    s.lo = lo;
+    s.binWidth = (uint16_t)(((int32_t)hi - lo) / JSTATS_BINS + 1);
+#else
+    (void)lo;
+    (void)hi;
+#endif
+    _jstatsClear(s);
+    return jstatsIndex++;
+}
+
+#if JSTATS_BINS > 0
+/**
+ * @brief Estima um percentil (0.0 a 1.0) pelo histograma, interpolando dentro da faixa.
+ *
+ * A interpolação vai de max(início da faixa, mínimo) a min(fim da faixa, máximo + 1): uma
+ * janela uniforme 0..99 inteira na primeira faixa (0..127) dá p50 = 50, e não 64. As faixas
+ * das pontas também recebem as amostras fora de [lo, hi] e vão até o mínimo ou máximo.
+ */
+int16_t _jstatsPercentile(const JStats_t &s, float p) {
+    const float target = p * s.n;
+    uint32_t acc = 0;
+    for (uint8_t b = 0; b < JSTATS_BINS; b++) {
+        if (s.hist[b] == 0) continue;
+        if (acc + s.hist[b] >= target) {
+            const float edge = (float)s.lo + (float)b * s.binWidth;
+            const float binLo = (b == 0 || edge < s.min) ? (float)s.min : edge;
+            const float binHi = (b == JSTATS_BINS - 1 || edge + s.binWidth > s.max + 1.0f) ? s.max + 1.0f : edge + s.binWidth;
+            const float v = binLo + (target - acc) / s.hist[b] * (binHi - binLo);
+            return (int16_t)constrain(v, (float)s.min, (float)s.max);
+        }
+        acc += s.hist[b];
+    }
+    return s.max;
+}
+#endif
+
+/**
+ * @brief Fecha a janela do canal, entrega o resumo e começa uma nova.
+ * @param id Índice retornado por jstatsAdd().
+ */
+void jstatsFlush(int8_t id) {
+    if (id < 0 || id >= jstatsIndex) return;
+    JStats_t &s = jstatsStruct[id];
+    if (s.n > 0 && s.callback != NULL) {
+        JStatsSummary_t r;
+        r.t0 = s.t0;
+        r.span = (uint32_t)(s.tEnd - s.t0);
+        r.count = s.n;
+        r.min = s.min;
+        r.max = s.max;
+        r.mean = (float)s.mean;
+        r.rms = sqrtf((float)((double)s.sumSq / s.n));
+        r.std = s.n > 1 ? sqrtf((float)(s.m2 / (s.n - 1))) : 0.0f;
+#if JSTATS_BINS > 0
+        r.p50 = _jstatsPercentile(s, 0.50f);
+        r.p90 = _jstatsPercentile(s, 0.90f);
+        r.p99 = _jstatsPercentile(s, 0.99f);
+#endif
+        s.callback(s.channel, r);
+    }
+    _jstatsClear(s);
+}
+
+/**
+ * @brief Acumula um bloco de amostras nos canais que o acompanham.
+ * @param channel Canal do bloco.
+ * @param data Amostras (no máximo 65535 por chamada).
+ * @param count Número de amostras.
+ * @param t0 Instante (us) da primeira amostra.
+ * @param period Período de amostragem (us).
+ */
+void jstatsUpdate(uint8_t channel, const int16_t *data, size_t count, uint64_t t0, uint32_t period) {
+    if (count == 0) return;
+    for (uint8_t id = 0; id < jstatsIndex; id++) {
+        JStats_t &s = jstatsStruct[id];
+        if (s.channel != channel) continue;
+        if (s.n > 0 && t0 >= s.t0 + s.window) jstatsFlush(id);
+
+        // Redução inteira do bloco: sem desvios no laço e exata.
+        int64_t sum = 0;
+        uint64_t sumSq = 0;
+        int16_t lo = data[0];
+        int16_t hi = data[0];
+        for (size_t i = 0; i < count; i++) {
+            const int32_t v = data[i];
+            sum += v;
+            sumSq += (uint64_t)(v * v);
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+#if JSTATS_BINS > 0
+            int32_t b = (v - s.lo) / s.binWidth;
+            b = b < 0 ? 0 : (b >= JSTATS_BINS ? JSTATS_BINS - 1 : b);
+            s.hist[b]++;
+#endif
+        }
+
+        // Média e M2 do bloco a partir das somas exatas; depois a combinação de Chan.
+        const double nb = (double)count;
+        const double meanB = (double)sum / nb;
+        const double m2B = ((double)((int64_t)count * (int64_t)sumSq - sum * sum)) / nb;
+        const double na = (double)s.n;
+        const double delta = meanB - s.mean;
+        const double n = na + nb;
+        s.mean += delta * nb / n;
+        s.m2 += m2B + delta * delta * na * nb / n;
+        if (s.n == 0) s.t0 = t0;
+        s.sumSq += sumSq;
+        s.n += count;
+        s.min = lo < s.min ? lo : s.min;
+        s.max = hi > s.max ? hi : s.max;
+        s.tEnd = t0 + (uint64_t)count * period;
+        if (s.tEnd >= s.t0 + s.window) jstatsFlush(id);
+    }
+}
+
+/**
+ * @brief Acumula um bloco do pool (jpool.h).
+ */
+void jstatsBlock(const jBlock_t *b) {
+    jstatsUpdate(b->channel, b->data, b->count, b->t0, b->period);
+}
+
+/**
+ * @brief Acumula uma única leitura (por exemplo, IIKit.analogReadPot1()), com o instante atual.
+ */
+void jstatsSample(uint8_t channel, int16_t value) {
+    jstatsUpdate(channel, &value, 1, esp_timer_get_time(), 0);
+}
+
+/**
+ * @brief Escreve um resumo em uma linha: "stats ch=... n=... min=... max=... mean=... rms=... std=...".
+ *
+ * Com percentis: também "p50=... p90=... p99=...".
+ * @param out Saída (por exemplo, IIKit.WSerial).
+ */
+template <typename S>
+void jstatsPrint(S &out, uint8_t channel, const JStatsSummary_t &s) {
+    out.print("stats ch=");
+    out.print(channel);
+    out.print(" t0=");
+    out.print((uint32_t)(s.t0 / 1000ULL));
+    out.print(" n=");
+    out.print(s.count);
+    out.print(" min=");
+    out.print(s.min);
+    out.print(" max=");
+    out.print(s.max);
+    out.print(" mean=");
+    out.print(s.mean);
+    out.print(" rms=");
+    out.print(s.rms);
+    out.print(" std=");
+#if JSTATS_BINS > 0
+    out.print(s.std);
+    out.print(" p50=");
+    out.print(s.p50);
+    out.print(" p90=");
+    out.print(s.p90);
+    out.print(" p99=");
+    out.println(s.p99);
+#else
+    out.println(s.std);
+#endif
+}
+
+#endif
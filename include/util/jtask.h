@@ -6,7 +6,11 @@
  * utilizando a função micros() no loop principal, dispensando tanto a interrupção de timer quanto a fila.
  */
 
+#ifndef __JTASK_H
+#define __JTASK_H
+
 #include "Arduino.h"
+#include "jprof.h"
 
 #ifndef NUMTASKS
   /**
@@ -84,6 +88,7 @@ uint8_t jtaskChangePeriod(uint8_t handle, unsigned long period) {
  * é maior ou igual ao período configurado. Se sim, a tarefa é executada imediatamente e o tempo é atualizado.
  */
 void jtaskLoop() {
+  JPROF_SCOPE("jtask");
   unsigned long currentMicros = micros();
   for (uint8_t i = 0; i < jtaskIndex; i++) {
     if (currentMicros - jtaskStruct[i].lastExec >= jtaskStruct[i].period) {
@@ -91,4 +96,24 @@ void jtaskLoop() {
       jtaskStruct[i].task();
     }
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Retorna o tempo (em microssegundos) até a próxima tarefa vencer.
+ *
+ * Usada por jevent.h para dormir até o próximo vencimento em vez de consultar jtaskLoop() continuamente.
+ * @return 0 se alguma tarefa já venceu, UINT32_MAX se não houver tarefas.
+ */
+uint32_t jtaskNextDue() {
+  uint32_t next = UINT32_MAX;
+  unsigned long currentMicros = micros();
+  for (uint8_t i = 0; i < jtaskIndex; i++) {
+    const unsigned long elapsed = currentMicros - jtaskStruct[i].lastExec;
+    if (elapsed >= jtaskStruct[i].period) return 0;
+    const uint32_t remaining = jtaskStruct[i].period - elapsed;
+    if (remaining < next) next = remaining;
+  }
+  return next;
+}
+
+#endif
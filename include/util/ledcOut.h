@@ -0,0 +1,184 @@
+/**
+ * @file ledcOut.h
+ * @brief Saída PWM de alta resolução usando diretamente o periférico LEDC do ESP32.
+ *
+ * O canal é configurado uma vez com frequência e resolução escolhidas (até 16 bits) e,
+ * a partir daí, cada escrita vai direto aos registradores de duty do LEDC, sem passar
+ * pela busca genérica de pino do analogWrite().
+ *
+ * O registrador de duty do LEDC possui 4 bits fracionários: o hardware alterna o duty
+ * entre dois valores vizinhos ao longo de 16 períodos (dithering), o que acrescenta
+ * 4 bits de resolução efetiva ao valor médio da saída, útil após o filtro da saída 4-20mA.
+ *
+ * O timer usa o clock do APB, que para em light sleep: um canal com duty diferente de zero
+ * conta como ativo (LedcOut_c::anyActive()) e jsleep.h não dorme enquanto houver algum.
+ */
+
+#ifndef LEDC_OUT_H
+#define LEDC_OUT_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <soc/ledc_struct.h>
+
+#ifndef LEDC_OUT_CLK_HZ
+/**
+ * @brief Clock do timer do LEDC (APB, 80 MHz): freq * 2^bits não pode passar dele.
+ */
+#define LEDC_OUT_CLK_HZ 80000000UL
+#endif
+
+#ifndef LEDC_OUT_MIN_TICK_HZ
+/**
+ * @brief Menor freq * 2^bits aceito (REF_TICK de 1 MHz com o maior divisor do timer, 1023).
+ */
+#define LEDC_OUT_MIN_TICK_HZ 978UL
+#endif
+
+/**
+ * @brief Verifica se o timer do LEDC consegue gerar a frequência com a resolução pedida.
+ *
+ * Usada por LedcOut_c::begin() e pela validação da configuração (pwmFreq e pwmBits).
+ * @param freq Frequência do PWM em Hz.
+ * @param bits Resolução em bits (1 a 16).
+ */
+inline bool ledcOutValid(uint32_t freq, uint8_t bits) {
+    if (freq == 0 || bits < 1 || bits > 16) return false;
+    const uint64_t tick = (uint64_t)freq << bits;
+    return tick <= LEDC_OUT_CLK_HZ && tick >= LEDC_OUT_MIN_TICK_HZ;
+}
+
+/**
+ * @class LedcOut_c
+ * @brief Canal PWM do LEDC com escrita direta em registrador, dithering e rampas por hardware.
+ */
+class LedcOut_c {
+public:
+    /**
+     * @brief Configura o timer e o canal do LEDC e associa o pino.
+     *
+     * @param pin Pino de saída.
+     * @param channel Canal do LEDC (modo alta velocidade).
+     * @param timer Timer do LEDC (canais com a mesma frequência podem compartilhar o timer).
+     * @param freq Frequência do PWM em Hz.
+     * @param bits Resolução em bits (1 a 16). Deve satisfazer ledcOutValid(freq, bits).
+     * @return true se o LEDC aceitou a configuração. Caso contrário as escritas são ignoradas.
+     */
+    bool begin(uint8_t pin, ledc_channel_t channel, ledc_timer_t timer, uint32_t freq, uint8_t bits) {
+        _channel = channel;
+        _bits = bits;
+        _ready = false;
+        if (!ledcOutValid(freq, bits)) return false;
+        ledc_timer_config_t tcfg = {};
+        tcfg.speed_mode = LEDC_HIGH_SPEED_MODE;
+        tcfg.duty_resolution = (ledc_timer_bit_t)bits;
+        tcfg.timer_num = timer;
+        tcfg.freq_hz = freq;
+        tcfg.clk_cfg = LEDC_AUTO_CLK;
+        if (ledc_timer_config(&tcfg) != ESP_OK) return false;
+        ledc_channel_config_t ccfg = {};
+        ccfg.gpio_num = pin;
+        ccfg.speed_mode = LEDC_HIGH_SPEED_MODE;
+        ccfg.channel = channel;
+        ccfg.intr_type = LEDC_INTR_DISABLE;
+        ccfg.timer_sel = timer;
+        ccfg.duty = 0;
+        ccfg.hpoint = 0;
+        _ready = ledc_channel_config(&ccfg) == ESP_OK;
+        _activeMask &= ~(1UL << _channel);
+        return _ready;
+    }
+
+    /**
+     * @brief Escreve o duty com 4 bits fracionários diretamente no registrador.
+     *
+     * @param duty16 Duty em 1/16 de LSB (0 a maxDuty() * 16).
+     */
+    inline void IRAM_ATTR writeRaw(uint32_t duty16) {
+        if (!_ready) return; // Canal não configurado: pode pertencer a outro código.
+        if (!_dither) duty16 &= ~0x0FUL;
+        if (duty16 != 0) _activeMask |= 1UL << _channel;
+        else _activeMask &= ~(1UL << _channel);
+        auto &ch = LEDC.channel_group[LEDC_HIGH_SPEED_MODE].channel[_channel];
+        ch.duty.duty = duty16;
+        ch.conf0.sig_out_en = 1;
+        ch.conf1.val = (1UL << 31) | (1UL << 30) | (1UL << 20) | (1UL << 10); // duty_start, duty_inc, duty_num = duty_cycle = 1
+    }
+
+    /**
+     * @brief Escreve o duty em LSBs inteiros (0 a maxDuty()).
+     */
+    inline void write(uint32_t duty) {
+        writeRaw(duty << 4);
+    }
+
+    /**
+     * @brief Escreve o duty como fração do período (0.0 a 1.0).
+     *
+     * Com o dithering habilitado a parte fracionária do LSB é aproveitada.
+     */
+    inline void writeFraction(float fraction) {
+        fraction = constrain(fraction, 0.0f, 1.0f);
+        writeRaw((uint32_t)(fraction * (float)(maxDuty() << 4) + 0.5f));
+    }
+
+    /**
+     * @brief Escreve o duty em Q16 (65536 = 100%), formato de saída de jcontrol.h.
+     */
+    inline void IRAM_ATTR writeQ16(int32_t q16) {
+        q16 = constrain(q16, 0, 65536);
+        writeRaw((uint32_t)(((uint64_t)q16 * (maxDuty() << 4)) >> 16));
+    }
+
+    /**
+     * @brief Inicia uma rampa por hardware até o duty indicado (não bloqueia).
+     *
+     * @param duty Duty final em LSBs inteiros.
+     * @param ms Duração da rampa em milissegundos.
+     */
+    void fade(uint32_t duty, uint32_t ms) {
+        if (!_ready) return;
+        if (!_fadeInstalled) {
+            ledc_fade_func_install(0);
+            _fadeInstalled = true;
+        }
+        _activeMask |= 1UL << _channel; // Ativo durante a rampa, até a próxima escrita de zero.
+        ledc_set_fade_with_time(LEDC_HIGH_SPEED_MODE, _channel, duty, ms);
+        ledc_fade_start(LEDC_HIGH_SPEED_MODE, _channel, LEDC_FADE_NO_WAIT);
+    }
+
+    /**
+     * @brief Habilita ou desabilita o uso dos 4 bits fracionários (dithering por hardware).
+     */
+    void setDither(bool dither) { _dither = dither; }
+
+    /**
+     * @brief Retorna o maior duty inteiro (2^bits - 1).
+     */
+    inline uint32_t maxDuty() const { return (1UL << _bits) - 1; }
+
+    /**
+     * @brief Retorna true se begin() foi bem-sucedido.
+     */
+    bool ready() const { return _ready; }
+
+    /**
+     * @brief Retorna true se algum canal tem duty diferente de zero ou rampa em andamento.
+     *
+     * Consultada por jsleep.h: com o clock do APB parado a saída congelaria.
+     */
+    static bool anyActive() { return _activeMask != 0; }
+
+private:
+    ledc_channel_t _channel = LEDC_CHANNEL_0;
+    uint8_t _bits = 8;
+    bool _dither = true;
+    bool _ready = false;
+    static bool _fadeInstalled;
+    static volatile uint32_t _activeMask; ///< Um bit por canal com duty diferente de zero.
+};
+
+bool LedcOut_c::_fadeInstalled = false;
+volatile uint32_t LedcOut_c::_activeMask = 0;
+
+#endif
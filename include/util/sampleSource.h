@@ -0,0 +1,170 @@
+/**
+ * @file sampleSource.h
+ * @brief Fontes de amostras substituíveis para a aquisição (AdcDmaEsp e ADS1115_c).
+ *
+ * Uma fonte retorna o valor do sinal em um instante qualquer (em microssegundos). Como o
+ * valor depende apenas do instante, e não de quando ou quantas vezes a fonte é consultada,
+ * os sinais sintetizados são reprodutíveis: o mesmo teste gera as mesmas amostras no
+ * simulador, no host (extras/host) ou na placa.
+ *
+ * SignalSource_c soma componentes configuráveis: nível DC, senoide, degrau, ruído
+ * pseudoaleatório determinístico e um traço gravado (tabela amostrada em período fixo).
+ */
+
+#ifndef __SAMPLE_SOURCE_H
+#define __SAMPLE_SOURCE_H
+
+#include <Arduino.h>
+
+/**
+ * @class SampleSource_c
+ * @brief Interface de uma fonte de amostras.
+ */
+class SampleSource_c {
+public:
+    virtual ~SampleSource_c() {}
+
+    /**
+     * @brief Retorna o valor do sinal no instante t.
+     * @param t Instante em microssegundos.
+     */
+    virtual int16_t sample(uint64_t t) = 0;
+
+    /**
+     * @brief Preenche um buffer com amostras igualmente espaçadas.
+     *
+     * @param buffer Destino das amostras.
+     * @param count Número de amostras.
+     * @param t0 Instante (us) da primeira amostra.
+     * @param period Período de amostragem (us).
+     */
+    void read(int16_t *buffer, size_t count, uint64_t t0, uint32_t period) {
+        for (size_t i = 0; i < count; i++) {
+            buffer[i] = sample(t0 + (uint64_t)i * period);
+        }
+    }
+};
+
+/**
+ * @class SignalSource_c
+ * @brief Sintetizador de sinais de teste: DC + senoide + degrau + ruído + traço gravado.
+ *
+ * Todos os componentes começam desligados (amplitude zero); o resultado é limitado a
+ * [minValue, maxValue] (padrão: 0 a 4095, faixa do ADC de 12 bits).
+ */
+class SignalSource_c : public SampleSource_c {
+public:
+    /**
+     * @brief Define o nível DC.
+     */
+    SignalSource_c &dc(int16_t offset) {
+        _offset = offset;
+        return *this;
+    }
+
+    /**
+     * @brief Define a componente senoidal.
+     * @param amplitude Amplitude de pico (contagens).
+     * @param hz Frequência em Hz.
+     * @param phase Fase inicial em radianos.
+     */
+    SignalSource_c &sine(float amplitude, float hz, float phase = 0.0f) {
+        _sineAmp = amplitude;
+        _sineHz = hz;
+        _sinePhase = phase;
+        return *this;
+    }
+
+    /**
+     * @brief Define um degrau que começa no instante at.
+     * @param height Altura do degrau (contagens).
+     * @param at Instante (us) do degrau.
+     */
+    SignalSource_c &step(int16_t height, uint64_t at) {
+        _stepHeight = height;
+        _stepAt = at;
+        return *this;
+    }
+
+    /**
+     * @brief Define o ruído uniforme em [-amplitude, amplitude].
+     * @param amplitude Amplitude do ruído (contagens).
+     * @param seed Semente; a mesma semente gera a mesma sequência.
+     */
+    SignalSource_c &noise(uint16_t amplitude, uint32_t seed = 1) {
+        _noiseAmp = amplitude;
+        _seed = seed;
+        return *this;
+    }
+
+    /**
+     * @brief Define um traço gravado, repetido indefinidamente.
+     * @param data Amostras do traço (não são copiadas).
+     * @param len Número de amostras.
+     * @param period Período (us) entre amostras do traço.
+     */
+    SignalSource_c &trace(const int16_t *data, size_t len, uint32_t period) {
+        _trace = data;
+        _traceLen = len;
+        _tracePeriod = period;
+        return *this;
+    }
+
+    /**
+     * @brief Define a faixa de saída (saturação do conversor simulado).
+     */
+    SignalSource_c &range(int16_t minValue, int16_t maxValue) {
+        _min = minValue;
+        _max = maxValue;
+        return *this;
+    }
+
+    int16_t sample(uint64_t t) override {
+        float v = _offset;
+        if (_sineAmp != 0.0f) {
+            // Fase exata em ciclos: segundos inteiros * Hz é exato em double (24 + 20 bits
+            // para dias de simulação) e só a fração de segundo passa por arredondamento, sem
+            // saltos de fase quando o período não é um número inteiro de us.
+            const double cycles = (double)(t / 1000000ULL) * _sineHz + (double)(t % 1000000ULL) * _sineHz * 1e-6;
+            const float frac = (float)(cycles - floor(cycles));
+            v += _sineAmp * sinf(2.0f * (float)M_PI * frac + _sinePhase);
+        }
+        if (_stepHeight != 0 && t >= _stepAt) v += _stepHeight;
+        if (_noiseAmp != 0) {
+            const uint32_t r = (uint32_t)(mix(t ^ ((uint64_t)_seed << 32)) >> 32);
+            v += (int32_t)(r % (2U * _noiseAmp + 1U)) - (int32_t)_noiseAmp;
+        }
+        if (_trace != NULL && _traceLen > 0 && _tracePeriod > 0) {
+            v += _trace[(t / _tracePeriod) % _traceLen];
+        }
+        const int32_t out = (int32_t)lroundf(v);
+        return (int16_t)constrain(out, (int32_t)_min, (int32_t)_max);
+    }
+
+private:
+    /**
+     * @brief Função de espalhamento (splitmix64): ruído determinístico a partir do instante.
+     */
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    int16_t _offset = 0;
+    float _sineAmp = 0.0f;
+    float _sineHz = 0.0f;
+    float _sinePhase = 0.0f;
+    int16_t _stepHeight = 0;
+    uint64_t _stepAt = 0;
+    uint16_t _noiseAmp = 0;
+    uint32_t _seed = 1;
+    const int16_t *_trace = NULL;
+    size_t _traceLen = 0;
+    uint32_t _tracePeriod = 0;
+    int16_t _min = 0;
+    int16_t _max = 4095;
+};
+
+#endif
@@ -0,0 +1,464 @@
+/**
+ * @file spiffs.h
+ * @brief Registrador de dados (data logger) em memória flash usando LittleFS ou SPIFFS.
+ *
+ * Os dados são gravados em arquivos de segmento somente-anexação ("/log/00000001.bin", ...),
+ * cada um formado por páginas de LOGGER_PAGE_SIZE bytes. As amostras são acumuladas em uma
+ * página na RAM e só são gravadas quando a página enche, de forma que cada escrita na flash
+ * é sempre de uma página inteira (menos desgaste e latência previsível). flush() grava a
+ * página incompleta mas a mantém aberta: as amostras seguintes continuam nela e ela é
+ * regravada no mesmo lugar, sem consumir uma página nova a cada flush() ou dump().
+ *
+ * Formato binário de uma página:
+ * - LogPageHeader_t (16 bytes): primeiro e último instante da página e bytes utilizados;
+ * - sequência de registros: LogRecordHeader_t (16 bytes) seguido de count amostras int16_t;
+ * - o restante da página é preenchido com 0xFF.
+ *
+ * Os cabeçalhos de página servem de índice: em begin() apenas o primeiro e o último
+ * cabeçalho de cada segmento são lidos para montar, na RAM, a faixa de tempo de cada
+ * segmento. Consultas por intervalo de tempo pulam segmentos e páginas fora da faixa.
+ * Quando o número de segmentos ou o espaço livre se esgota, o segmento mais antigo é apagado.
+ *
+ * Defina LOGGER_USE_SPIFFS para usar SPIFFS no lugar de LittleFS.
+ */
+
+#ifndef __SPIFFS_LOGGER_H
+#define __SPIFFS_LOGGER_H
+
+#include <Arduino.h>
+#ifdef LOGGER_USE_SPIFFS
+#include <SPIFFS.h>
+#define LOGGER_FS SPIFFS
+#else
+#include <LittleFS.h>
+#define LOGGER_FS LittleFS
+#endif
+#include "../services/wserialmini_c.h"
+
+#ifndef LOGGER_PAGE_SIZE
+/**
+ * @brief Tamanho (bytes) da página acumulada na RAM e gravada de uma só vez.
+ */
+#define LOGGER_PAGE_SIZE 4096
+#endif
+
+#ifndef LOGGER_SEGMENT_PAGES
+/**
+ * @brief Número de páginas por arquivo de segmento.
+ */
+#define LOGGER_SEGMENT_PAGES 16
+#endif
+
+#ifndef LOGGER_MAX_SEGMENTS
+/**
+ * @brief Número máximo de segmentos mantidos na flash (e no índice em RAM).
+ */
+#define LOGGER_MAX_SEGMENTS 32
+#endif
+
+#ifndef LOGGER_DIR
+/**
+ * @brief Diretório dos arquivos de segmento.
+ */
+#define LOGGER_DIR "/log"
+#endif
+
+#ifndef LOGGER_SCAN_PASSES
+/**
+ * @brief Número máximo de varreduras do diretório em begin() (cada uma apaga até
+ * LOGGER_MAX_SEGMENTS arquivos).
+ */
+#define LOGGER_SCAN_PASSES 4
+#endif
+
+#define LOGGER_PAGE_MAGIC 0x474F4C49UL ///< "ILOG" em little-endian.
+
+/**
+ * @struct LogPageHeader_t
+ * @brief Cabeçalho gravado no início de cada página.
+ */
+typedef struct {
+    uint32_t magic;     ///< LOGGER_PAGE_MAGIC.
+    uint16_t used;      ///< Bytes utilizados na página (incluindo este cabeçalho).
+    uint16_t records;   ///< Número de registros na página.
+    uint32_t tFirst;    ///< Instante (ms) da primeira amostra da página.
+    uint32_t tLast;     ///< Instante (ms) da última amostra da página.
+} LogPageHeader_t;
+
+/**
+ * @struct LogRecordHeader_t
+ * @brief Cabeçalho de um registro (bloco de amostras de um canal).
+ */
+typedef struct {
+    uint16_t count;     ///< Número de amostras int16_t após o cabeçalho.
+    uint8_t channel;    ///< Canal de origem das amostras.
+    uint8_t flags;      ///< Reservado.
+    uint32_t period;    ///< Período de amostragem em microssegundos.
+    uint64_t t0;        ///< Instante (us) da primeira amostra.
+} LogRecordHeader_t;
+
+/**
+ * @struct LogSegment_t
+ * @brief Entrada do índice em RAM de um segmento.
+ */
+typedef struct {
+    uint32_t seq;       ///< Número de sequência (nome do arquivo).
+    uint32_t tFirst;    ///< Instante (ms) da primeira amostra do segmento.
+    uint32_t tLast;     ///< Instante (ms) da última amostra do segmento.
+    uint16_t pages;     ///< Páginas gravadas no segmento.
+} LogSegment_t;
+
+/**
+ * @class Logger_c
+ * @brief Registrador de blocos de amostras em segmentos paginados na flash.
+ */
+class Logger_c {
+public:
+    /**
+     * @brief Monta o sistema de arquivos, reconstrói o índice e abre um novo segmento.
+     * @param formatOnFail Formata a partição se a montagem falhar.
+     * @return true se o registrador está pronto para gravar.
+     */
+    bool begin(bool formatOnFail = true);
+
+    /**
+     * @brief Acrescenta um bloco de amostras ao registro.
+     *
+     * Blocos maiores que uma página são divididos em vários registros.
+     * @param channel Canal de origem.
+     * @param t0 Instante (us) da primeira amostra.
+     * @param period Período de amostragem (us).
+     * @param data Amostras.
+     * @param count Número de amostras.
+     * @return true se todas as amostras foram aceitas.
+     */
+    bool append(uint8_t channel, uint64_t t0, uint32_t period, const int16_t *data, size_t count);
+
+    /**
+     * @brief Grava a página corrente, mesmo incompleta.
+     *
+     * Use antes de desligar ou de ler o registro. A página continua aberta na RAM e as
+     * próximas amostras são acrescentadas a ela.
+     * @return true se a gravação foi bem-sucedida.
+     */
+    bool flush(void);
+
+    /**
+     * @brief Envia pela serial os registros com amostras no intervalo [from, to] (ms).
+     *
+     * No modo texto cada amostra é enviada no formato de gráfico do WSerialmini_c
+     * (">logN:t:valor|g"). No modo binário as páginas são enviadas sem conversão.
+     * @param ws Serial de saída.
+     * @param from Início do intervalo (ms).
+     * @param to Fim do intervalo (ms).
+     * @param binary true para enviar as páginas em binário.
+     * @return Número de registros (texto) ou páginas (binário) enviados.
+     */
+    size_t dump(WSerialmini_c *ws, uint32_t from = 0, uint32_t to = UINT32_MAX, bool binary = false);
+
+    /**
+     * @brief Retorna o número de segmentos existentes.
+     */
+    uint8_t segments(void) const { return _nSeg; }
+
+    /**
+     * @brief Retorna a entrada do índice do segmento i (0 é o mais antigo).
+     */
+    const LogSegment_t &segment(uint8_t i) const { return _index[i]; }
+
+    /**
+     * @brief Retorna o número de páginas descartadas por falha de escrita.
+     */
+    uint32_t lost(void) const { return _lost; }
+
+protected:
+    bool writePage(bool close = true);
+    bool putPage(void);
+    bool openSegment(void);
+    static bool parseSegmentName(const char *name, uint32_t &seq);
+    bool readSegment(File &f, LogSegment_t &seg);
+    void removeOldest(void);
+    void resetPage(void);
+    void segmentPath(char *path, uint32_t seq) const;
+
+    __attribute__((aligned(4))) uint8_t _page[LOGGER_PAGE_SIZE]; ///< Página em montagem na RAM.
+    LogSegment_t _index[LOGGER_MAX_SEGMENTS]; ///< Índice dos segmentos, do mais antigo ao mais novo.
+    uint8_t _nSeg = 0;
+    File _file;
+    bool _ready = false;
+    bool _partial = false; ///< A página da RAM já foi gravada incompleta (última página do segmento).
+    uint32_t _lost = 0;
+};
+
+void Logger_c::segmentPath(char *path, uint32_t seq) const {
+    sprintf(path, LOGGER_DIR "/%08lu.bin", (unsigned long)seq);
+}
+
+/**
+ * @brief Extrai o número de sequência de um nome "%08lu.bin" (com ou sem o diretório).
+ *
+ * Só a forma exata é aceita, de modo que segmentPath(seq) volta ao mesmo arquivo.
+ * @return false se o nome não é de um segmento.
+ */
+bool Logger_c::parseSegmentName(const char *name, uint32_t &seq) {
+    const char *slash = strrchr(name, '/');
+    if (slash != NULL) name = slash + 1;
+    if (strlen(name) != 12 || strcmp(name + 8, ".bin") != 0) return false;
+    seq = 0;
+    for (uint8_t i = 0; i < 8; i++) {
+        if (name[i] < '0' || name[i] > '9') return false;
+        seq = seq * 10 + (name[i] - '0');
+    }
+    return true;
+}
+
+bool Logger_c::readSegment(File &f, LogSegment_t &seg) {
+    seg.pages = f.size() / LOGGER_PAGE_SIZE;
+    LogPageHeader_t first, last;
+    if (seg.pages == 0 || f.read((uint8_t *)&first, sizeof(first)) != sizeof(first) || first.magic != LOGGER_PAGE_MAGIC) {
+        return false;
+    }
+    f.seek((uint32_t)(seg.pages - 1) * LOGGER_PAGE_SIZE);
+    if (f.read((uint8_t *)&last, sizeof(last)) != sizeof(last) || last.magic != LOGGER_PAGE_MAGIC) return false;
+    seg.tFirst = first.tFirst;
+    seg.tLast = last.tLast;
+    return true;
+}
+
+bool Logger_c::begin(bool formatOnFail) {
+    if (!LOGGER_FS.begin(formatOnFail)) return false;
+    LOGGER_FS.mkdir(LOGGER_DIR);
+    // Os segmentos a apagar (vazios, corrompidos ou além de LOGGER_MAX_SEGMENTS) são apenas
+    // anotados durante a listagem do diretório e removidos depois dela; se a lista encher,
+    // a varredura é repetida, no máximo LOGGER_SCAN_PASSES vezes (o que sobrar fica para o
+    // próximo begin()). Arquivos com nome fora do formato dos segmentos são ignorados.
+    uint32_t stale[LOGGER_MAX_SEGMENTS];
+    bool again = true;
+    for (uint8_t pass = 0; again && pass < LOGGER_SCAN_PASSES; pass++) {
+        uint8_t nStale = 0;
+        again = false;
+        _nSeg = 0;
+        File dir = LOGGER_FS.open(LOGGER_DIR);
+        for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+            LogSegment_t seg;
+            if (!parseSegmentName(f.name(), seg.seq)) {
+                f.close();
+                continue;
+            }
+            bool valid = readSegment(f, seg);
+            f.close();
+            if (valid && _nSeg == LOGGER_MAX_SEGMENTS) {
+                // Índice cheio: mantém os mais novos, independentemente da ordem da listagem.
+                if (seg.seq < _index[0].seq) {
+                    valid = false;
+                } else {
+                    const uint32_t oldest = _index[0].seq;
+                    memmove(&_index[0], &_index[1], (_nSeg - 1) * sizeof(LogSegment_t));
+                    _nSeg--;
+                    if (nStale < LOGGER_MAX_SEGMENTS) stale[nStale++] = oldest;
+                    else again = true;
+                }
+            }
+            if (!valid) {
+                if (nStale < LOGGER_MAX_SEGMENTS) stale[nStale++] = seg.seq;
+                else again = true;
+                continue;
+            }
+            // Inserção ordenada por número de sequência.
+            uint8_t i = _nSeg++;
+            while (i > 0 && _index[i - 1].seq > seg.seq) {
+                _index[i] = _index[i - 1];
+                i--;
+            }
+            _index[i] = seg;
+        }
+        dir.close();
+        char path[32];
+        for (uint8_t i = 0; i < nStale; i++) {
+            segmentPath(path, stale[i]);
+            LOGGER_FS.remove(path);
+        }
+    }
+    _partial = false;
+    resetPage();
+    _ready = openSegment();
+    return _ready;
+}
+
+void Logger_c::resetPage(void) {
+    LogPageHeader_t *hdr = (LogPageHeader_t *)_page;
+    hdr->magic = LOGGER_PAGE_MAGIC;
+    hdr->used = sizeof(LogPageHeader_t);
+    hdr->records = 0;
+    hdr->tFirst = 0;
+    hdr->tLast = 0;
+}
+
+void Logger_c::removeOldest(void) {
+    if (_nSeg == 0) return;
+    char path[32];
+    segmentPath(path, _index[0].seq);
+    LOGGER_FS.remove(path);
+    memmove(&_index[0], &_index[1], (_nSeg - 1) * sizeof(LogSegment_t));
+    _nSeg--;
+}
+
+bool Logger_c::openSegment(void) {
+    const uint32_t segBytes = (uint32_t)LOGGER_SEGMENT_PAGES * LOGGER_PAGE_SIZE;
+    while (_nSeg > 0 && (_nSeg >= LOGGER_MAX_SEGMENTS || LOGGER_FS.usedBytes() + segBytes > LOGGER_FS.totalBytes())) {
+        removeOldest();
+    }
+    LogSegment_t &seg = _index[_nSeg];
+    seg.seq = (_nSeg > 0) ? _index[_nSeg - 1].seq + 1 : 1;
+    seg.pages = 0;
+    seg.tFirst = 0;
+    seg.tLast = 0;
+    char path[32];
+    segmentPath(path, seg.seq);
+    _file = LOGGER_FS.open(path, "w");
+    if (!_file) return false;
+    _nSeg++;
+    return true;
+}
+
+bool Logger_c::putPage(void) {
+    LogPageHeader_t *hdr = (LogPageHeader_t *)_page;
+    LogSegment_t &seg = _index[_nSeg - 1];
+    // Uma página já gravada incompleta é a última do segmento e é regravada no lugar.
+    const uint16_t p = _partial ? seg.pages - 1 : seg.pages;
+    memset(_page + hdr->used, 0xFF, LOGGER_PAGE_SIZE - hdr->used);
+    if (!_file.seek((uint32_t)p * LOGGER_PAGE_SIZE)) return false;
+    if (_file.write(_page, LOGGER_PAGE_SIZE) != LOGGER_PAGE_SIZE) return false;
+    if (!_partial && seg.pages++ == 0) seg.tFirst = hdr->tFirst;
+    seg.tLast = hdr->tLast;
+    return true;
+}
+
+bool Logger_c::writePage(bool close) {
+    LogPageHeader_t *hdr = (LogPageHeader_t *)_page;
+    if (hdr->records == 0) return true;
+    if (!putPage()) {
+        // Flash cheia ou falha de escrita: a página continua na RAM e vai para um segmento
+        // novo, depois de liberar o mais antigo. A cópia incompleta anterior deixa o índice.
+        _file.close();
+        if (_partial) _index[_nSeg - 1].pages--;
+        _partial = false;
+        if (_nSeg > 1) removeOldest();
+        _ready = openSegment();
+        if (!_ready || !putPage()) {
+            _lost++;
+            resetPage();
+            return false;
+        }
+    }
+    if (!close) {
+        _partial = true;
+        _file.flush();
+        return true;
+    }
+    _partial = false;
+    resetPage();
+    if (_index[_nSeg - 1].pages >= LOGGER_SEGMENT_PAGES) {
+        _file.close();
+        _ready = openSegment();
+    } else {
+        _file.flush();
+    }
+    return true;
+}
+
+bool Logger_c::append(uint8_t channel, uint64_t t0, uint32_t period, const int16_t *data, size_t count) {
+    while (_ready && count > 0) {
+        LogPageHeader_t *hdr = (LogPageHeader_t *)_page;
+        const size_t room = LOGGER_PAGE_SIZE - hdr->used;
+        if (room < sizeof(LogRecordHeader_t) + sizeof(int16_t)) {
+            writePage();
+            continue;
+        }
+        size_t n = (room - sizeof(LogRecordHeader_t)) / sizeof(int16_t);
+        if (n > count) n = count;
+        LogRecordHeader_t rec;
+        rec.count = n;
+        rec.channel = channel;
+        rec.flags = 0;
+        rec.period = period;
+        rec.t0 = t0;
+        memcpy(_page + hdr->used, &rec, sizeof(rec));
+        memcpy(_page + hdr->used + sizeof(rec), data, n * sizeof(int16_t));
+        hdr->used += sizeof(rec) + n * sizeof(int16_t);
+        const uint32_t tFirst = (uint32_t)(t0 / 1000ULL);
+        const uint32_t tLast = (uint32_t)((t0 + (uint64_t)(n - 1) * period) / 1000ULL);
+        if (hdr->records++ == 0 || tFirst < hdr->tFirst) hdr->tFirst = tFirst;
+        if (tLast > hdr->tLast) hdr->tLast = tLast;
+        t0 += (uint64_t)n * period;
+        data += n;
+        count -= n;
+    }
+    return count == 0;
+}
+
+bool Logger_c::flush(void) {
+    return _ready && writePage(false);
+}
+
+size_t Logger_c::dump(WSerialmini_c *ws, uint32_t from, uint32_t to, bool binary) {
+    flush();
+    size_t sent = 0;
+    char path[32];
+    char varName[8];
+    int16_t samples[32];
+    for (uint8_t s = 0; s < _nSeg; s++) {
+        const LogSegment_t &seg = _index[s];
+        if (seg.pages == 0 || seg.tLast < from || seg.tFirst > to) continue;
+        segmentPath(path, seg.seq);
+        File f = LOGGER_FS.open(path, "r");
+        if (!f) continue;
+        for (uint16_t p = 0; p < seg.pages; p++) {
+            const uint32_t base = (uint32_t)p * LOGGER_PAGE_SIZE;
+            LogPageHeader_t hdr;
+            f.seek(base);
+            if (f.read((uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != LOGGER_PAGE_MAGIC) break;
+            if (hdr.tLast < from || hdr.tFirst > to) continue;
+            if (binary) {
+                uint8_t chunk[256];
+                f.seek(base);
+                size_t off = 0;
+                while (off < LOGGER_PAGE_SIZE) {
+                    const size_t n = f.read(chunk, sizeof(chunk));
+                    if (n == 0) break;
+                    ws->write(chunk, n);
+                    off += n;
+                }
+                if (off < LOGGER_PAGE_SIZE) break; // Leitura interrompida: segmento truncado.
+                sent++;
+                continue;
+            }
+            bool ok = true;
+            for (uint16_t r = 0; ok && r < hdr.records; r++) {
+                LogRecordHeader_t rec;
+                if (f.read((uint8_t *)&rec, sizeof(rec)) != sizeof(rec) ||
+                    rec.count > (LOGGER_PAGE_SIZE - sizeof(LogPageHeader_t) - sizeof(rec)) / sizeof(int16_t)) {
+                    ok = false; // Página corrompida: ignora o restante dela.
+                    break;
+                }
+                sprintf(varName, "log%u", rec.channel);
+                for (uint16_t i = 0; i < rec.count; i += 32) {
+                    const uint16_t n = (rec.count - i < 32) ? rec.count - i : 32;
+                    if (f.read((uint8_t *)samples, n * sizeof(int16_t)) != n * sizeof(int16_t)) {
+                        ok = false;
+                        break;
+                    }
+                    for (uint16_t k = 0; k < n; k++) {
+                        const uint32_t t = (uint32_t)((rec.t0 + (uint64_t)(i + k) * rec.period) / 1000ULL);
+                        if (t >= from && t <= to) ws->plot(varName, t, samples[k]);
+                    }
+                }
+                sent++;
+            }
+        }
+        f.close();
+    }
+    return sent;
+}
+
+#endif